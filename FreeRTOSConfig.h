@@ -25,6 +25,7 @@
  */
 
 #include "trace_task_switch.h"
+#include "tick_profile.h"
 #include <stdint.h>
 
 #ifndef FREERTOS_CONFIG_H
@@ -45,16 +46,50 @@
 #define configUSE_TRACE_FACILITY                 1
 #define configGENERATE_RUN_TIME_STATS            0
 
-#define configUSE_PREEMPTION                     1
-#define configUSE_TIME_SLICING                   1
+// Build variants for the experiment runner (tools/run_matrix.py). Override
+// with -DUSE_PREEMPTION=0 and -DUSE_TIME_SLICING=0
+#ifndef USE_PREEMPTION
+#define USE_PREEMPTION                           1
+#endif
+#ifndef USE_TIME_SLICING
+#define USE_TIME_SLICING                         1
+#endif
+#define configUSE_PREEMPTION                     USE_PREEMPTION
+// Round-robin quantum of tasks of equal priority in microseconds. 0 rotates
+// them on the tick if USE_TIME_SLICING is set; above 0 the tick no longer
+// slices and the quantum timer does, see quantum_timer.h. Override with
+// -DTIME_SLICE_QUANTUM_US=<us>
+#ifndef TIME_SLICE_QUANTUM_US
+#define TIME_SLICE_QUANTUM_US                    0
+#endif
+#if TIME_SLICE_QUANTUM_US > 0
+#define configUSE_TIME_SLICING                   0
+#else
+#define configUSE_TIME_SLICING                   USE_TIME_SLICING
+#endif
 #define configUSE_IDLE_HOOK                      1
+// 1 stops the tick while the idle task sleeps (the port's SysTick-based
+// tickless idle); 0 keeps it running and the idle hook sleeps on WFI between
+// ticks. Override with -DTICKLESS_IDLE=1
+#ifndef TICKLESS_IDLE
+#define TICKLESS_IDLE                            0
+#endif
+#define configUSE_TICKLESS_IDLE                  TICKLESS_IDLE
+#define configPRE_SLEEP_PROCESSING( x )          tickProfilePreSleep( x )
+#define configPOST_SLEEP_PROCESSING( x )         tickProfilePostSleep( x )
+#define traceINCREASE_TICK_COUNT( x )            tickProfileStepped( x )
 #define configUSE_TICK_HOOK                      0
 #define configCPU_CLOCK_HZ                       ( ( unsigned long ) 50000000 )  // 50 MHz for QEMU Cortex-M3
-#define configTICK_RATE_HZ                       ( ( TickType_t ) 100 )
-// #define configTICK_RATE_HZ                       ( 1 )
+// Kernel tick rate, from TICK_RATE_MIN_HZ (100) to TICK_RATE_MAX_HZ (10 kHz)
+// and dividing 1 MHz so a tick is a whole number of microseconds. Override
+// with -DTICK_RATE_HZ=<Hz>, see tick_profile.h
+#ifndef TICK_RATE_HZ
+#define TICK_RATE_HZ                             100
+#endif
+#define configTICK_RATE_HZ                       ( ( TickType_t ) TICK_RATE_HZ )
 // #define configMINIMAL_STACK_SIZE                 ( ( unsigned short ) 128 )
 #define configMINIMAL_STACK_SIZE                 ( ( unsigned short ) 256 )
-#define configTOTAL_HEAP_SIZE                    ( ( size_t ) ( 64 * 1024 ) )
+#define configTOTAL_HEAP_SIZE                    ( ( size_t ) ( 128 * 1024 ) )
 #define configMAX_TASK_NAME_LEN                  ( 16 )
 // #define configUSE_TRACE_FACILITY                 0
 #define configUSE_16_BIT_TICKS                   0
@@ -69,14 +104,14 @@
 #define configUSE_COUNTING_SEMAPHORES            1
 #define configSUPPORT_DYNAMIC_ALLOCATION         1
 
-#define configMAX_PRIORITIES                     ( 9UL )
+#define configMAX_PRIORITIES                     ( 32UL ) /* One level per periodic task of the task set table. */
 #define configMAX_CO_ROUTINE_PRIORITIES          ( 2 )
 #define configQUEUE_REGISTRY_SIZE                10
 #define configSUPPORT_STATIC_ALLOCATION          1
 
 /* Timer related defines. */
 #define configUSE_TIMERS                         1
-#define configTIMER_TASK_PRIORITY                ( configMAX_PRIORITIES - 4 )
+#define configTIMER_TASK_PRIORITY                ( configMAX_PRIORITIES - 1 )  /* Deadline watchdogs must preempt the tasks they monitor. */
 #define configTIMER_QUEUE_LENGTH                 40
 #define configTIMER_TASK_STACK_DEPTH             ( configMINIMAL_STACK_SIZE * 4 )
 
@@ -119,8 +154,11 @@
 #define configPRIO_BITS                        3
 #define configLIBRARY_LOWEST_INTERRUPT_PRIORITY     7
 #define configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY 4
-#define configKERNEL_INTERRUPT_PRIORITY             configLIBRARY_LOWEST_INTERRUPT_PRIORITY
-#define configMAX_SYSCALL_INTERRUPT_PRIORITY        configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY
+/* The kernel writes these straight into the priority registers, so they are
+ * shifted into the implemented top bits; NVIC_SetPriority() takes the
+ * unshifted library values. */
+#define configKERNEL_INTERRUPT_PRIORITY             ( configLIBRARY_LOWEST_INTERRUPT_PRIORITY << ( 8 - configPRIO_BITS ) )
+#define configMAX_SYSCALL_INTERRUPT_PRIORITY        ( configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY << ( 8 - configPRIO_BITS ) )
 
 
 
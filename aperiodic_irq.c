@@ -0,0 +1,164 @@
+#include "aperiodic_irq.h"
+#include "arrival_model.h"
+#include "hires_timer.h"
+#include "tiny_print.h"
+#include "CMSDK_CM3.h"
+
+// Latency samples in high resolution timer counts
+typedef struct {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+} LatencyStats;
+
+static const AperiodicIrqConfig *irqConfig = NULL;
+
+static volatile uint32_t irqArrivals[APERIODIC_IRQ_SOURCES];
+static uint32_t pendingComputationUs[APERIODIC_IRQ_SOURCES];  // Job of each timer's next expiry
+static uint32_t lastScheduledCounts = 0;   // Arrival time of the latest event handed to a timer
+static volatile uint32_t irqDropped = 0;
+static LatencyStats isrEntryLatency = { .min = UINT32_MAX };      // Timer expiry to handler entry
+static LatencyStats serverStartLatency = { .min = UINT32_MAX };   // Timer expiry to the server starting the job
+
+static void recordLatency(LatencyStats *stats, uint32_t counts)
+{
+    stats->count++;
+    stats->total += counts;
+    if (counts < stats->min) {
+        stats->min = counts;
+    }
+    if (counts > stats->max) {
+        stats->max = counts;
+    }
+}
+
+// Hand the next event of the arrival model to a timer; returns its arrival
+// time. The timers take the events in turn, so together they raise exactly
+// the arrival sequence of the model.
+static uint32_t scheduleNextArrival(UBaseType_t source)
+{
+    ArrivalEvent event = arrivalNext();
+
+    lastScheduledCounts += hiresUsToCounts(event.delayUs);
+    pendingComputationUs[source] = event.computationUs;
+    return lastScheduledCounts;
+}
+
+// Common body of the timer handlers. The timers count at the peripheral clock,
+// as does the DUALTIMER1 behind hiresNow(), so RELOAD - VALUE is the number of
+// high resolution counts since the timer expired and raised the interrupt.
+static void aperiodicIrqHandler(CMSDK_TIMER_TypeDef *timer, UBaseType_t source)
+{
+    uint32_t entryCounts = hiresNow();
+    uint32_t sinceExpiry = timer->RELOAD - timer->VALUE;
+    BaseType_t higherPriorityTaskWoken = pdFALSE;
+
+    timer->INTCLEAR = CMSDK_TIMER_INTCLEAR_Msk;
+    if (irqConfig == NULL) {
+        return;
+    }
+
+    // Reload for this timer's next arrival, measured from the expiry rather
+    // than the handler entry so handler latency does not stretch the arrivals
+    uint32_t expiryCounts = entryCounts - sinceExpiry;
+    uint32_t computationUs = pendingComputationUs[source];
+    uint32_t interval = scheduleNextArrival(source) - expiryCounts;
+
+    if ((int32_t)interval <= 0) {
+        interval = 1;
+    }
+    timer->RELOAD = interval;
+    timer->VALUE = (int32_t)(interval - sinceExpiry) > 0 ? interval - sinceExpiry : 1;
+
+    AperiodicJob *job = aperiodicJobAlloc();
+
+    irqArrivals[source]++;
+    recordLatency(&isrEntryLatency, sinceExpiry);
+
+    if (job == NULL) {
+        // Pool exhausted: the servers are too far behind
+        irqDropped++;
+        return;
+    }
+    job->arrivalTime = xTaskGetTickCountFromISR();
+    job->computationUs = computationUs;
+    job->arrivalCounts = expiryCounts;
+    job->source = (uint8_t)(APERIODIC_SOURCE_TIMER0 + source);
+    aperiodicQueuePush(irqConfig->jobQueue, job);
+
+    vTaskNotifyGiveFromISR(irqConfig->server, &higherPriorityTaskWoken);
+    portYIELD_FROM_ISR(higherPriorityTaskWoken);
+}
+
+void TIMER0_Handler(void)
+{
+    aperiodicIrqHandler(CMSDK_TIMER0, 0);
+}
+
+void TIMER1_Handler(void)
+{
+    aperiodicIrqHandler(CMSDK_TIMER1, 1);
+}
+
+static void startTimer(CMSDK_TIMER_TypeDef *timer, UBaseType_t source, uint32_t startCounts)
+{
+    uint32_t interval = scheduleNextArrival(source) - startCounts;
+
+    if (interval == 0) {
+        interval = 1;
+    }
+    timer->CTRL = 0;
+    timer->INTCLEAR = CMSDK_TIMER_INTCLEAR_Msk;
+    timer->RELOAD = interval;
+    timer->VALUE = interval;
+    timer->CTRL = CMSDK_TIMER_CTRL_EN_Msk | CMSDK_TIMER_CTRL_IRQEN_Msk;
+}
+
+// Program both timers with their first arrival; arrivalModelInit() must have
+// run. The NVIC lines are enabled by vApplicationSetupInterrupts(), at a
+// priority that may call the FromISR API; the kernel holds the handlers off
+// until the scheduler starts.
+void aperiodicIrqStart(const AperiodicIrqConfig *config)
+{
+    uint32_t startCounts = hiresNow();
+
+    irqConfig = config;
+    lastScheduledCounts = startCounts;
+    startTimer(CMSDK_TIMER0, 0, startCounts);
+    startTimer(CMSDK_TIMER1, 1, startCounts);
+}
+
+// Called by the servers when they begin serving a job
+void aperiodicIrqServerStart(const AperiodicJob *job)
+{
+    if (job->source == APERIODIC_SOURCE_TASK) {
+        return;
+    }
+    recordLatency(&serverStartLatency, hiresNow() - job->arrivalCounts);
+}
+
+static void printLatency(const char *name, const LatencyStats *stats)
+{
+    if (stats->count == 0) {
+        printf("%s,0,0,0,0\n", name);
+        return;
+    }
+    printf("%s,%lu,%lu,%lu,%lu\n", name, stats->count, hiresCountsToNs(stats->min),
+           hiresCountsToNs((uint32_t)(stats->total / stats->count)), hiresCountsToNs(stats->max));
+}
+
+void printAperiodicIrqLatency(void)
+{
+    if (irqConfig == NULL) {
+        return;
+    }
+
+    printf("\n==== Aperiodic Interrupt Latency ====\n");
+    printf("TIMER0 Arrivals: %lu\n", irqArrivals[0]);
+    printf("TIMER1 Arrivals: %lu\n", irqArrivals[1]);
+    printf("Arrivals Dropped: %lu\n", irqDropped);
+    printf("Latency,Samples,Min (ns),Mean (ns),Max (ns)\n");
+    printLatency("ISR Entry", &isrEntryLatency);
+    printLatency("IRQ to Server Start", &serverStartLatency);
+}
@@ -0,0 +1,24 @@
+#ifndef APERIODIC_IRQ_H
+#define APERIODIC_IRQ_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "aperiodic_job.h"
+
+// Aperiodic events raised by the CMSDK TIMER0 and TIMER1 interrupts. The
+// arrivals of the model in arrival_model.h are dealt to the two timers in
+// turn; on expiry a handler reloads its timer for its next arrival, queues the
+// job descriptor and wakes the server with vTaskNotifyGiveFromISR().
+#define APERIODIC_IRQ_SOURCES  2
+
+// Passed to aperiodicIrqStart(); must outlive the scheduler
+typedef struct {
+    AperiodicJobQueue *jobQueue;  // Destination of the AperiodicJob requests
+    TaskHandle_t server;          // Task notified on every arrival
+} AperiodicIrqConfig;
+
+void aperiodicIrqStart(const AperiodicIrqConfig *config);
+void aperiodicIrqServerStart(const AperiodicJob *job);
+void printAperiodicIrqLatency(void);
+
+#endif /* APERIODIC_IRQ_H */
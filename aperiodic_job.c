@@ -0,0 +1,94 @@
+#include "aperiodic_job.h"
+#include "CMSDK_CM3.h"
+
+#if APERIODIC_POOL_SIZE < 1 || APERIODIC_POOL_SIZE > 32
+#error "APERIODIC_POOL_SIZE must be between 1 and 32"
+#endif
+
+static AperiodicJob jobPool[APERIODIC_POOL_SIZE];
+
+// One bit per descriptor, set while it is free
+static volatile uint32_t freeJobs = (uint32_t)((1ULL << APERIODIC_POOL_SIZE) - 1);
+
+// The updates below are LDREX/STREX retry loops. An exception between the
+// two clears the exclusive monitor, so a task preempted by an ISR touching
+// the same word simply retries; nothing ever masks interrupts.
+
+AperiodicJob *aperiodicJobAlloc(void)
+{
+    uint32_t free;
+    uint32_t index;
+
+    do {
+        free = __LDREXW(&freeJobs);
+        if (free == 0) {
+            __CLREX();
+            return NULL;
+        }
+        index = 31 - __CLZ(free);
+    } while (__STREXW(free & ~(1UL << index), &freeJobs) != 0);
+
+    return &jobPool[index];
+}
+
+void aperiodicJobFree(AperiodicJob *job)
+{
+    uint32_t index = (uint32_t)(job - jobPool);
+    uint32_t free;
+
+    configASSERT(index < APERIODIC_POOL_SIZE);
+    do {
+        free = __LDREXW(&freeJobs);
+    } while (__STREXW(free | (1UL << index), &freeJobs) != 0);
+}
+
+uint32_t aperiodicJobsInUse(void)
+{
+    uint32_t free = freeJobs;
+    uint32_t inUse = APERIODIC_POOL_SIZE;
+
+    while (free != 0) {
+        free &= free - 1;
+        inUse--;
+    }
+    return inUse;
+}
+
+void aperiodicQueuePush(AperiodicJobQueue *queue, AperiodicJob *job)
+{
+    AperiodicJob *head;
+
+    do {
+        head = (AperiodicJob *)__LDREXW((volatile uint32_t *)&queue->pushed);
+        job->next = head;
+    } while (__STREXW((uint32_t)job, (volatile uint32_t *)&queue->pushed) != 0);
+}
+
+// Server side only. Detaching the whole stack with one exchange avoids the
+// ABA problem of popping single nodes while producers push.
+AperiodicJob *aperiodicQueuePop(AperiodicJobQueue *queue)
+{
+    if (queue->pending == NULL) {
+        AperiodicJob *detached;
+
+        do {
+            detached = (AperiodicJob *)__LDREXW((volatile uint32_t *)&queue->pushed);
+        } while (__STREXW(0, (volatile uint32_t *)&queue->pushed) != 0);
+
+        // Reverse into arrival order
+        while (detached != NULL) {
+            AperiodicJob *next = detached->next;
+
+            detached->next = queue->pending;
+            queue->pending = detached;
+            detached = next;
+        }
+    }
+
+    AperiodicJob *job = queue->pending;
+    if (job != NULL) {
+        queue->pending = job->next;
+        job->next = NULL;
+    }
+    return job;
+}
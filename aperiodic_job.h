@@ -0,0 +1,39 @@
+#ifndef APERIODIC_JOB_H
+#define APERIODIC_JOB_H
+
+#include "FreeRTOS.h"
+
+#define APERIODIC_POOL_SIZE 16  // Job descriptors shared by all sources, at most 32
+
+// Origin of an aperiodic job
+#define APERIODIC_SOURCE_TASK    0  // Task-level event producer
+#define APERIODIC_SOURCE_TIMER0  1  // CMSDK TIMER0 interrupt
+#define APERIODIC_SOURCE_TIMER1  2  // CMSDK TIMER1 interrupt
+
+// One aperiodic request as handed from the event producer to a server
+typedef struct AperiodicJob {
+    TickType_t arrivalTime;   // Tick at which the event arrived
+    uint32_t computationUs;   // Required execution time in microseconds
+    uint32_t arrivalCounts;   // High resolution timestamp of the arrival
+    uint32_t startCounts;     // High resolution timestamp of the start of service
+    uint8_t source;           // APERIODIC_SOURCE_*
+    struct AperiodicJob *next;  // Link in an AperiodicJobQueue
+} AperiodicJob;
+
+// Handoff from any number of producers, tasks or ISRs, to a single server.
+// Producers push onto a lock-free stack; the server detaches the whole stack
+// at once and serves it in arrival order from its private list.
+typedef struct {
+    AperiodicJob *volatile pushed;  // Newest first, shared with the producers
+    AperiodicJob *pending;          // Oldest first, owned by the server
+} AperiodicJobQueue;
+
+// Descriptors come from a static pool; both calls are O(1) and safe from tasks and ISRs
+AperiodicJob *aperiodicJobAlloc(void);
+void aperiodicJobFree(AperiodicJob *job);
+uint32_t aperiodicJobsInUse(void);
+
+void aperiodicQueuePush(AperiodicJobQueue *queue, AperiodicJob *job);
+AperiodicJob *aperiodicQueuePop(AperiodicJobQueue *queue);
+
+#endif /* APERIODIC_JOB_H */
@@ -0,0 +1,123 @@
+#include "aperiodic_response.h"
+#include "aperiodic_irq.h"
+#include "hires_timer.h"
+#include "tiny_print.h"
+
+// Distribution of one per-job delay, in microseconds
+typedef struct {
+    uint32_t samples[APERIODIC_RESPONSE_SAMPLES];
+    uint64_t total;
+    uint32_t max;
+} DelayDistribution;
+
+static uint32_t aperiodicServed = 0;
+static DelayDistribution responseTimes;    // Arrival to completion
+static DelayDistribution queueingDelays;   // Arrival to the start of service
+
+// Generator of the reservoir slots, separate from the arrival model's so that
+// sampling never shifts the arrival sequence
+static uint32_t reservoirSeed = 0x2545F491UL;
+
+static uint32_t nextReservoirDraw(void)
+{
+    reservoirSeed ^= reservoirSeed << 13;
+    reservoirSeed ^= reservoirSeed >> 17;
+    reservoirSeed ^= reservoirSeed << 5;
+    return reservoirSeed;
+}
+
+// Reservoir slot of the job served as number aperiodicServed: its own slot
+// while the reservoir fills, then a random slot with probability
+// APERIODIC_RESPONSE_SAMPLES / (aperiodicServed + 1), else none
+static uint32_t reservoirSlot(void)
+{
+    if (aperiodicServed < APERIODIC_RESPONSE_SAMPLES) {
+        return aperiodicServed;
+    }
+    return nextReservoirDraw() % (aperiodicServed + 1);
+}
+
+static void recordDelay(DelayDistribution *distribution, uint32_t slot, uint32_t delayUs)
+{
+    if (slot < APERIODIC_RESPONSE_SAMPLES) {
+        distribution->samples[slot] = delayUs;
+    }
+    distribution->total += delayUs;
+    if (delayUs > distribution->max) {
+        distribution->max = delayUs;
+    }
+}
+
+// Called by the servers when they begin serving a job; a job split across
+// budget replenishments keeps the start of its first slice
+void aperiodicJobStart(AperiodicJob *job)
+{
+    job->startCounts = hiresNow();
+    aperiodicIrqServerStart(job);
+}
+
+// Called by the servers when a job completes
+void aperiodicJobComplete(const AperiodicJob *job)
+{
+    uint32_t now = hiresNow();
+    uint32_t slot = reservoirSlot();
+
+    // Both delays of a job share the slot, so the two rows sample the same jobs
+    recordDelay(&responseTimes, slot, hiresCountsToUs(now - job->arrivalCounts));
+    recordDelay(&queueingDelays, slot, hiresCountsToUs(job->startCounts - job->arrivalCounts));
+    aperiodicServed++;
+}
+
+static void sortSamples(uint32_t *samples, uint32_t count)
+{
+    for (uint32_t i = 1; i < count; ++i) {
+        uint32_t value = samples[i];
+        uint32_t j = i;
+
+        while (j > 0 && samples[j - 1] > value) {
+            samples[j] = samples[j - 1];
+            j--;
+        }
+        samples[j] = value;
+    }
+}
+
+// Nearest-rank percentile of sorted samples
+static uint32_t percentile(const uint32_t *sorted, uint32_t count, uint32_t percent)
+{
+    uint32_t rank = (count * percent + 99) / 100;
+
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+static void printDistribution(const char *name, DelayDistribution *distribution, uint32_t kept)
+{
+    if (aperiodicServed == 0) {
+        printf("%s,0,0,0,0,0\n", name);
+        return;
+    }
+
+    sortSamples(distribution->samples, kept);
+    printf("%s,%lu,%lu,%lu,%lu,%lu\n",
+           name,
+           (uint32_t)(distribution->total / aperiodicServed),
+           percentile(distribution->samples, kept, 50),
+           percentile(distribution->samples, kept, 95),
+           percentile(distribution->samples, kept, 99),
+           distribution->max);
+}
+
+// Called within the server report, which gets the job counts; the
+// distribution follows as its own section. Sorts the samples in place, so it
+// is called once at the end of the run.
+void printAperiodicResponseTimes(void)
+{
+    uint32_t kept = aperiodicServed < APERIODIC_RESPONSE_SAMPLES ? aperiodicServed : APERIODIC_RESPONSE_SAMPLES;
+
+    printf("Aperiodic Jobs Served: %lu\n", aperiodicServed);
+    printf("Percentile Samples: %lu\n", kept);
+    printf("\n==== Aperiodic Response Times ====\n");
+    printf("Metric,Mean (us),P50 (us),P95 (us),P99 (us),Max (us)\n");
+    printDistribution("Response Time", &responseTimes, kept);
+    printDistribution("Queueing Delay", &queueingDelays, kept);
+}
@@ -0,0 +1,16 @@
+#ifndef APERIODIC_RESPONSE_H
+#define APERIODIC_RESPONSE_H
+
+#include "FreeRTOS.h"
+#include "aperiodic_job.h"
+
+// A uniform random sample of APERIODIC_RESPONSE_SAMPLES served jobs is kept
+// for the percentiles (reservoir sampling), so they describe the whole run
+// like the count, mean and maximum
+#define APERIODIC_RESPONSE_SAMPLES  256
+
+void aperiodicJobStart(AperiodicJob *job);
+void aperiodicJobComplete(const AperiodicJob *job);
+void printAperiodicResponseTimes(void);
+
+#endif /* APERIODIC_RESPONSE_H */
@@ -0,0 +1,147 @@
+#include "arrival_model.h"
+
+#ifndef ARRIVAL_TRACE_FILE
+#define ARRIVAL_TRACE_FILE "arrival_traces/default.h"
+#endif
+
+// Trace replayed by ARRIVAL_TRACE, selected at build time with ARRIVAL_TRACE
+#define ARRIVAL_TRACE_ENTRY(delayUs, computationUs) { (delayUs), (computationUs) },
+static const ArrivalEvent arrivalTrace[] = {
+#include ARRIVAL_TRACE_FILE
+};
+#undef ARRIVAL_TRACE_ENTRY
+
+#define ARRIVAL_TRACE_LENGTH  ( sizeof(arrivalTrace) / sizeof(arrivalTrace[0]) )
+
+static const ArrivalModelConfig *modelConfig = NULL;
+static uint32_t prngState = 1;
+
+// State of the bursty model
+static BaseType_t inBurst = pdFALSE;
+static uint32_t remainingStayUs = 0;
+
+static uint32_t traceIndex = 0;
+
+void prngSeed(uint32_t seed)
+{
+    // Zero is the one state xorshift never leaves
+    prngState = seed != 0 ? seed : 1;
+}
+
+// Marsaglia xorshift32
+uint32_t prngNext(void)
+{
+    uint32_t x = prngState;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    prngState = x;
+    return x;
+}
+
+static uint32_t uniformBetween(uint32_t min, uint32_t max)
+{
+    if (max <= min) {
+        return min;
+    }
+    return min + prngNext() % (max - min + 1);
+}
+
+// Natural logarithm for the exponential draws, without libm: x = m * 2^e with
+// m in [1, 2), and ln(m) from the atanh series, accurate to about 1e-5
+static float naturalLog(float x)
+{
+    int exponent = 0;
+
+    while (x >= 2.0f) {
+        x *= 0.5f;
+        exponent++;
+    }
+    while (x < 1.0f) {
+        x *= 2.0f;
+        exponent--;
+    }
+
+    float z = (x - 1.0f) / (x + 1.0f);
+    float z2 = z * z;
+    float series = 1.0f + z2 * (1.0f / 3 + z2 * (1.0f / 5 + z2 * (1.0f / 7 + z2 * (1.0f / 9))));
+
+    return exponent * 0.69314718f + 2.0f * z * series;
+}
+
+// Exponentially distributed draw with the given mean, by inversion
+static uint32_t exponentialDelay(uint32_t meanUs)
+{
+    // U in (0, 1] with 24 bits, so ln(U) is finite
+    float u = (float)((prngNext() >> 8) + 1) / 16777216.0f;
+    float delay = -naturalLog(u) * (float)meanUs;
+
+    return delay >= 4294967295.0f ? UINT32_MAX : (uint32_t)delay;
+}
+
+// Markov-modulated Poisson process with a calm and a burst state. Both the
+// arrivals and the state changes are memoryless, so when the state changes
+// before the next arrival the remaining wait is simply redrawn in the new state.
+static uint32_t burstyDelay(void)
+{
+    uint32_t delayUs = 0;
+
+    for (;;) {
+        uint32_t toArrival = exponentialDelay(inBurst ? modelConfig->burstMeanDelayUs : modelConfig->calmMeanDelayUs);
+
+        if (toArrival <= remainingStayUs) {
+            remainingStayUs -= toArrival;
+            return delayUs + toArrival;
+        }
+        delayUs += remainingStayUs;
+        inBurst = !inBurst;
+        remainingStayUs = exponentialDelay(inBurst ? modelConfig->burstMeanStayUs : modelConfig->calmMeanStayUs);
+    }
+}
+
+void arrivalModelInit(const ArrivalModelConfig *config)
+{
+    modelConfig = config;
+    prngSeed(config->seed);
+    inBurst = pdFALSE;
+    remainingStayUs = exponentialDelay(config->calmMeanStayUs);
+    traceIndex = 0;
+}
+
+// Next event of the model. Called from one source only, either the producer
+// task or the timer interrupts, so the state needs no locking.
+ArrivalEvent arrivalNext(void)
+{
+    ArrivalEvent event;
+
+    if (modelConfig->model == ARRIVAL_TRACE) {
+        event = arrivalTrace[traceIndex];
+        traceIndex = (traceIndex + 1) % ARRIVAL_TRACE_LENGTH;
+        return event;
+    }
+
+    switch (modelConfig->model) {
+        case ARRIVAL_POISSON:
+            event.delayUs = exponentialDelay(modelConfig->meanDelayUs);
+            break;
+        case ARRIVAL_BURSTY:
+            event.delayUs = burstyDelay();
+            break;
+        default:
+            event.delayUs = uniformBetween(modelConfig->delayMinUs, modelConfig->delayMaxUs);
+            break;
+    }
+    event.computationUs = uniformBetween(modelConfig->computationMinUs, modelConfig->computationMaxUs);
+    return event;
+}
+
+const char *arrivalModelName(void)
+{
+    switch (modelConfig != NULL ? modelConfig->model : ARRIVAL_UNIFORM) {
+        case ARRIVAL_POISSON: return "Poisson";
+        case ARRIVAL_BURSTY:  return "Bursty";
+        case ARRIVAL_TRACE:   return "Trace";
+        default:              return "Uniform";
+    }
+}
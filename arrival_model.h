@@ -0,0 +1,41 @@
+#ifndef ARRIVAL_MODEL_H
+#define ARRIVAL_MODEL_H
+
+#include "FreeRTOS.h"
+
+// Interarrival process of the aperiodic events
+#define ARRIVAL_UNIFORM  0  // Uniform interarrival times
+#define ARRIVAL_POISSON  1  // Exponential interarrival times
+#define ARRIVAL_BURSTY   2  // Two-state Markov-modulated Poisson process
+#define ARRIVAL_TRACE    3  // Replay of ARRIVAL_TRACE_FILE, repeated when it runs out
+
+// Parameters of the arrival model, passed to arrivalModelInit(); must outlive the scheduler
+typedef struct {
+    UBaseType_t model;          // ARRIVAL_*
+    uint32_t seed;              // Seed of the generator, the same seed gives the same arrivals
+    uint32_t delayMinUs;        // ARRIVAL_UNIFORM interarrival range
+    uint32_t delayMaxUs;
+    uint32_t meanDelayUs;       // ARRIVAL_POISSON mean interarrival time
+    uint32_t calmMeanDelayUs;   // ARRIVAL_BURSTY mean interarrival time in the calm state
+    uint32_t burstMeanDelayUs;  // ARRIVAL_BURSTY mean interarrival time in the burst state
+    uint32_t calmMeanStayUs;    // ARRIVAL_BURSTY mean time in the calm state
+    uint32_t burstMeanStayUs;   // ARRIVAL_BURSTY mean time in the burst state
+    uint32_t computationMinUs;  // Computation range of a job, except under ARRIVAL_TRACE
+    uint32_t computationMaxUs;
+} ArrivalModelConfig;
+
+// One aperiodic event drawn from the model
+typedef struct {
+    uint32_t delayUs;           // Time since the previous arrival
+    uint32_t computationUs;     // Required execution time
+} ArrivalEvent;
+
+void arrivalModelInit(const ArrivalModelConfig *config);
+ArrivalEvent arrivalNext(void);
+const char *arrivalModelName(void);
+
+// Seedable xorshift generator behind the models
+void prngSeed(uint32_t seed);
+uint32_t prngNext(void);
+
+#endif /* ARRIVAL_MODEL_H */
@@ -0,0 +1,46 @@
+// Example trace: runs of eight arrivals 60-140 ms apart, each followed by a
+// burst of six events 3-12 ms apart; generated by tools/arrival_trace.py
+//
+// ARRIVAL_TRACE_ENTRY(delay since the previous arrival (us), computation (us))
+ARRIVAL_TRACE_ENTRY(109000, 6400)
+ARRIVAL_TRACE_ENTRY(93000, 4400)
+ARRIVAL_TRACE_ENTRY(65000, 4300)
+ARRIVAL_TRACE_ENTRY(62000, 6800)
+ARRIVAL_TRACE_ENTRY(82000, 3800)
+ARRIVAL_TRACE_ENTRY(71000, 4700)
+ARRIVAL_TRACE_ENTRY(89000, 6200)
+ARRIVAL_TRACE_ENTRY(81000, 4900)
+ARRIVAL_TRACE_ENTRY(3000, 6100)
+ARRIVAL_TRACE_ENTRY(5000, 6800)
+ARRIVAL_TRACE_ENTRY(5000, 5900)
+ARRIVAL_TRACE_ENTRY(6000, 6900)
+ARRIVAL_TRACE_ENTRY(11000, 6600)
+ARRIVAL_TRACE_ENTRY(12000, 2900)
+ARRIVAL_TRACE_ENTRY(107000, 1300)
+ARRIVAL_TRACE_ENTRY(97000, 6000)
+ARRIVAL_TRACE_ENTRY(118000, 4100)
+ARRIVAL_TRACE_ENTRY(110000, 3900)
+ARRIVAL_TRACE_ENTRY(65000, 6700)
+ARRIVAL_TRACE_ENTRY(90000, 4400)
+ARRIVAL_TRACE_ENTRY(73000, 5700)
+ARRIVAL_TRACE_ENTRY(93000, 4500)
+ARRIVAL_TRACE_ENTRY(4000, 1300)
+ARRIVAL_TRACE_ENTRY(3000, 2500)
+ARRIVAL_TRACE_ENTRY(3000, 1600)
+ARRIVAL_TRACE_ENTRY(10000, 2600)
+ARRIVAL_TRACE_ENTRY(7000, 2600)
+ARRIVAL_TRACE_ENTRY(6000, 1300)
+ARRIVAL_TRACE_ENTRY(76000, 6400)
+ARRIVAL_TRACE_ENTRY(63000, 1500)
+ARRIVAL_TRACE_ENTRY(128000, 6900)
+ARRIVAL_TRACE_ENTRY(110000, 1200)
+ARRIVAL_TRACE_ENTRY(62000, 7000)
+ARRIVAL_TRACE_ENTRY(72000, 2700)
+ARRIVAL_TRACE_ENTRY(76000, 6700)
+ARRIVAL_TRACE_ENTRY(102000, 5800)
+ARRIVAL_TRACE_ENTRY(4000, 3300)
+ARRIVAL_TRACE_ENTRY(8000, 1300)
+ARRIVAL_TRACE_ENTRY(9000, 4800)
+ARRIVAL_TRACE_ENTRY(4000, 2600)
+ARRIVAL_TRACE_ENTRY(9000, 5200)
+ARRIVAL_TRACE_ENTRY(6000, 5000)
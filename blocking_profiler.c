@@ -0,0 +1,226 @@
+#include "blocking_profiler.h"
+#include "hires_timer.h"
+#include "tiny_print.h"
+#include <task.h>
+
+// State of a task that has requested a resource and not yet acquired it
+typedef struct {
+    ResourceHandle_t resource;     // NULL when the task is not waiting
+    TaskHandle_t holderAtRequest;
+    UBaseType_t holderPriority;
+    UBaseType_t priority;
+    TickType_t requestTime;
+    uint32_t requestCounts;
+    BaseType_t inverted;           // A lower-priority non-holder ran during the wait
+    TickType_t inversionStart;
+    uint32_t inversionCounts;      // Time such tasks ran, in high resolution counts
+    int intruderId;
+} WaitState;
+
+// Per-task totals over the run
+typedef struct {
+    uint32_t takes;
+    uint32_t totalWaitUs;
+    uint32_t totalHoldUs;
+    uint32_t inversions;
+    uint32_t totalInversionUs;
+} TaskProfile;
+
+static WaitState waitState[MAX_TASKS];
+static TaskProfile taskProfile[MAX_TASKS];
+
+static ProfilerEpisode worstWaits[PROFILER_WORST_CASES];
+static ProfilerEpisode worstHolds[PROFILER_WORST_CASES];
+static ProfilerEpisode worstInversions[PROFILER_WORST_CASES];
+
+static int taskIdOf(TaskHandle_t xTaskHandle)
+{
+    UBaseType_t taskIndex = findTaskIndex(xTaskHandle);
+    return taskIndex < MAX_TASKS ? (int)taskIndex : -1;
+}
+
+// Replace the shortest entry of a worst-case list if the new episode is longer
+static void keepWorst(ProfilerEpisode *list, const ProfilerEpisode *episode)
+{
+    UBaseType_t shortest = 0;
+
+    for (UBaseType_t i = 1; i < PROFILER_WORST_CASES; ++i) {
+        if (list[i].durationUs < list[shortest].durationUs) {
+            shortest = i;
+        }
+    }
+    if (episode->durationUs > list[shortest].durationUs) {
+        list[shortest] = *episode;
+    }
+}
+
+void profilerOnRequest(ResourceHandle_t resource, UBaseType_t taskPriority, TickType_t requestTime, uint32_t requestCounts)
+{
+    UBaseType_t taskIndex = findTaskIndex(xTaskGetCurrentTaskHandle());
+
+    if (taskIndex >= MAX_TASKS) {
+        return;
+    }
+
+    taskENTER_CRITICAL();
+    {
+        WaitState *state = &waitState[taskIndex];
+        state->holderAtRequest = resource->holder;
+        state->holderPriority = resource->holderBasePriority;
+        state->priority = taskPriority;
+        state->requestTime = requestTime;
+        state->requestCounts = requestCounts;
+        state->inverted = pdFALSE;
+        state->inversionStart = 0;
+        state->inversionCounts = 0;
+        state->intruderId = -1;
+        state->resource = resource;
+    }
+    taskEXIT_CRITICAL();
+}
+
+void profilerOnAcquire(ResourceHandle_t resource, uint32_t acquiredCounts)
+{
+    UBaseType_t taskIndex = findTaskIndex(xTaskGetCurrentTaskHandle());
+    WaitState state;
+
+    if (taskIndex >= MAX_TASKS) {
+        return;
+    }
+
+    taskENTER_CRITICAL();
+    {
+        state = waitState[taskIndex];
+        waitState[taskIndex].resource = NULL;
+    }
+    taskEXIT_CRITICAL();
+
+    ProfilerEpisode wait = {
+        .resourceName = resource->name,
+        .taskId = (int)taskIndex,
+        .holderId = state.holderAtRequest ? taskIdOf(state.holderAtRequest) : -1,
+        .intruderId = -1,
+        .taskPriority = state.priority,
+        .holderPriority = state.holderPriority,
+        .start = state.requestTime,
+        .durationUs = hiresCountsToUs(acquiredCounts - state.requestCounts)
+    };
+
+    taskProfile[taskIndex].takes++;
+    taskProfile[taskIndex].totalWaitUs += wait.durationUs;
+    keepWorst(worstWaits, &wait);
+
+    // Every episode counts, however short the intruding slices were
+    if (state.inverted) {
+        ProfilerEpisode inversion = wait;
+        inversion.intruderId = state.intruderId;
+        inversion.start = state.inversionStart;
+        inversion.durationUs = hiresCountsToUs(state.inversionCounts);
+
+        taskProfile[taskIndex].inversions++;
+        taskProfile[taskIndex].totalInversionUs += inversion.durationUs;
+        keepWorst(worstInversions, &inversion);
+    }
+}
+
+// The request timed out; the task is no longer waiting
+void profilerOnTimeout(void)
+{
+    UBaseType_t taskIndex = findTaskIndex(xTaskGetCurrentTaskHandle());
+
+    if (taskIndex < MAX_TASKS) {
+        waitState[taskIndex].resource = NULL;
+    }
+}
+
+void profilerOnRelease(ResourceHandle_t resource, uint32_t releasedCounts)
+{
+    UBaseType_t taskIndex = findTaskIndex(resource->holder);
+
+    if (taskIndex >= MAX_TASKS) {
+        return;
+    }
+
+    ProfilerEpisode hold = {
+        .resourceName = resource->name,
+        .taskId = (int)taskIndex,
+        .holderId = (int)taskIndex,
+        .intruderId = -1,
+        .taskPriority = resource->holderBasePriority,
+        .holderPriority = resource->holderBasePriority,
+        .start = resource->acquiredAt,
+        .durationUs = hiresCountsToUs(releasedCounts - resource->acquiredCounts)
+    };
+
+    taskProfile[taskIndex].totalHoldUs += hold.durationUs;
+    keepWorst(worstHolds, &hold);
+}
+
+// A slice is an inversion for a waiting task H when the task that ran is neither
+// the holder L nor above H, yet outranks L: prio(L) < prio(M) < prio(H)
+void profilerOnTaskRan(UBaseType_t taskIndex, UBaseType_t priority, TickType_t switchedIn, uint32_t sliceCounts)
+{
+    for (UBaseType_t i = 0; i < MAX_TASKS; ++i) {
+        WaitState *state = &waitState[i];
+        ResourceHandle_t resource = state->resource;
+
+        if (resource == NULL || i == taskIndex || resource->holder == NULL ||
+            resource->holder == taskHandles[taskIndex]) {
+            continue;
+        }
+
+        if (priority > resource->holderBasePriority && priority < state->priority) {
+            if (!state->inverted) {
+                state->inverted = pdTRUE;
+                state->inversionStart = switchedIn;
+                state->intruderId = (int)taskIndex;
+            }
+            state->inversionCounts += sliceCounts;
+        }
+    }
+}
+
+static void printEpisodes(const char *title, const ProfilerEpisode *list)
+{
+    printf("\n---- Worst %s ----\n", title);
+    printf("Resource,Task,Priority,Holder,Holder Priority,Intruder,Start (tick),Duration (us)\n");
+
+    for (UBaseType_t i = 0; i < PROFILER_WORST_CASES; ++i) {
+        const ProfilerEpisode *episode = &list[i];
+
+        if (episode->durationUs == 0) {
+            continue;
+        }
+        printf("\"%s\",\"%s\",%lu,\"%s\",%lu,\"%s\",%lu,%lu\n",
+               episode->resourceName,
+               taskInfo[episode->taskId].taskName,
+               episode->taskPriority,
+               episode->holderId >= 0 ? taskInfo[episode->holderId].taskName : "-",
+               episode->holderPriority,
+               episode->intruderId >= 0 ? taskInfo[episode->intruderId].taskName : "-",
+               episode->start,
+               episode->durationUs);
+    }
+}
+
+void printBlockingProfile(void)
+{
+    printf("\n==== Blocking Profile ====\n");
+    printf("Task,Takes,Total Wait (us),Total Hold (us),Inversions,Inversion Time (us)\n");
+    for (UBaseType_t i = 0; i < MAX_TASKS; ++i) {
+        if (taskProfile[i].takes == 0) {
+            continue;
+        }
+        printf("\"%s\",%lu,%lu,%lu,%lu,%lu\n",
+               taskInfo[i].taskName,
+               taskProfile[i].takes,
+               taskProfile[i].totalWaitUs,
+               taskProfile[i].totalHoldUs,
+               taskProfile[i].inversions,
+               taskProfile[i].totalInversionUs);
+    }
+
+    printEpisodes("Waits", worstWaits);
+    printEpisodes("Holds", worstHolds);
+    printEpisodes("Priority Inversions", worstInversions);
+}
@@ -0,0 +1,34 @@
+#ifndef BLOCKING_PROFILER_H
+#define BLOCKING_PROFILER_H
+
+#include "FreeRTOS.h"
+#include "resource_ceiling.h"
+
+#define PROFILER_WORST_CASES 5   // Worst episodes kept per category
+
+// One recorded wait, hold or inversion episode
+typedef struct {
+    const char *resourceName;
+    int taskId;               // Waiting task (wait/inversion) or holder (hold)
+    int holderId;             // Holder that blocked the waiter, -1 if none
+    int intruderId;           // Lower-priority non-holder that ran during an inversion, -1 otherwise
+    UBaseType_t taskPriority;
+    UBaseType_t holderPriority;
+    TickType_t start;
+    uint32_t durationUs;
+} ProfilerEpisode;
+
+// Called by the resource layer around every take and give, with the tick and
+// the high resolution time (hiresNow()) of the event
+void profilerOnRequest(ResourceHandle_t resource, UBaseType_t taskPriority, TickType_t requestTime, uint32_t requestCounts);
+void profilerOnAcquire(ResourceHandle_t resource, uint32_t acquiredCounts);
+void profilerOnTimeout(void);
+void profilerOnRelease(ResourceHandle_t resource, uint32_t releasedCounts);
+
+// Called from the switch-out trace hook with the slice the task just ran: the
+// tick it was switched in at and its length in high resolution counts
+void profilerOnTaskRan(UBaseType_t taskIndex, UBaseType_t priority, TickType_t switchedIn, uint32_t sliceCounts);
+
+void printBlockingProfile(void);
+
+#endif /* BLOCKING_PROFILER_H */
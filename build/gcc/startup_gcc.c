@@ -32,10 +32,11 @@
 
 /* FreeRTOS interrupt handlers. */
 extern void vPortSVCHandler( void );
-extern void xPortPendSVHandler( void );
-extern void xPortSysTickHandler( void );
+extern void tickProfileSysTickHandler( void );
+extern void dispatchPendSVHandler( void );
 extern void TIMER0_Handler( void );
 extern void TIMER1_Handler( void );
+extern void DUALTIMER_Handler( void );
 
 /* Exception handlers. */
 static void HardFault_Handler( void ) __attribute__( ( naked ) );
@@ -62,11 +63,8 @@ const uint32_t* isr_vector[] __attribute__((section(".isr_vector"), used)) =
     ( uint32_t * ) &vPortSVCHandler,    // SVC_Handler          -5
     ( uint32_t * ) &Default_Handler,    // DebugMon_Handler     -4
     0, // reserved   -3
-    ( uint32_t * ) &xPortPendSVHandler, // PendSV handler       -2
-    ( uint32_t * ) &xPortSysTickHandler,// SysTick_Handler      -1
-    0,
-    0,
-    0,
+    ( uint32_t * ) &dispatchPendSVHandler, // PendSV handler    -2
+    ( uint32_t * ) &tickProfileSysTickHandler, // SysTick_Handler -1
     0,
     0,
     0,
@@ -75,6 +73,9 @@ const uint32_t* isr_vector[] __attribute__((section(".isr_vector"), used)) =
     0,
     0,
     0,
+    ( uint32_t * ) &TIMER0_Handler,     // Timer 0               8
+    ( uint32_t * ) &TIMER1_Handler,     // Timer 1               9
+    ( uint32_t * ) &DUALTIMER_Handler,  // Dual timer            10
     0,
     0,
     0, // Ethernet   13
@@ -0,0 +1,82 @@
+#include "cbs_server.h"
+#include "aperiodic_job.h"
+#include "edf_scheduler.h"
+#include "trace_task_switch.h"
+#include "workload.h"
+#include "aperiodic_response.h"
+#include "tiny_print.h"
+#include <task.h>
+
+static volatile uint32_t cbsDeadlinePostponements = 0;
+static volatile uint32_t cbsDeadlineRenewals = 0;
+
+// Constant Bandwidth Server (Abeni & Buttazzo). The server competes under EDF
+// with deadline ds and spends budget cs; when cs is exhausted it is recharged
+// and ds is postponed by one period, so the server can never demand more than
+// Qs/Ts of the processor no matter how bursty the arrivals are.
+void cbsServerTask(void *pvParameters)
+{
+    const CbsServerConfig *config = (const CbsServerConfig *)pvParameters;
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    const uint32_t maxBudgetUs = config->budget * US_PER_TICK;
+    uint32_t budgetUs = 0;
+    TickType_t deadline = xTaskGetTickCount();
+    AperiodicJob *job;
+
+    for (;;)
+    {
+        // Server is idle until a source notifies an arrival
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        job = aperiodicQueuePop(config->jobQueue);
+        if (job == NULL)
+        {
+            // Already served with an earlier notification
+            continue;
+        }
+
+        // Arrival while idle: keep (cs, ds) only if the residual budget would not
+        // exceed the server bandwidth before ds, i.e. cs < (ds - r) * Qs / Ts
+        TickType_t now = xTaskGetTickCount();
+        if ((int32_t)(deadline - now) <= 0 ||
+            (uint64_t)budgetUs * config->period >= (uint64_t)(deadline - now) * maxBudgetUs)
+        {
+            deadline = now + config->period;
+            budgetUs = maxBudgetUs;
+            cbsDeadlineRenewals++;
+        }
+        edfSetDeadline(self, deadline);
+
+        // Serve the backlog in FIFO order until the queue drains
+        do
+        {
+            aperiodicJobStart(job);
+            deferredServerActive = pdTRUE;
+            while (job->computationUs > 0)
+            {
+                if (budgetUs == 0)
+                {
+                    // Budget exhausted: recharge and postpone the deadline
+                    budgetUs = maxBudgetUs;
+                    deadline += config->period;
+                    cbsDeadlinePostponements++;
+                    edfSetDeadline(self, deadline);
+                }
+
+                uint32_t slice = job->computationUs < budgetUs ? job->computationUs : budgetUs;
+                burnExecutionTime(slice);
+                job->computationUs -= slice;
+                budgetUs -= slice;
+            }
+            deferredServerActive = pdFALSE;
+
+            aperiodicJobComplete(job);
+            aperiodicJobFree(job);
+        } while ((job = aperiodicQueuePop(config->jobQueue)) != NULL);
+    }
+}
+
+void printCbsServerStats(void)
+{
+    printf("CBS Deadline Renewals: %lu\n", cbsDeadlineRenewals);
+    printf("CBS Deadline Postponements: %lu\n", cbsDeadlinePostponements);
+}
@@ -0,0 +1,17 @@
+#ifndef CBS_SERVER_H
+#define CBS_SERVER_H
+
+#include "FreeRTOS.h"
+#include "aperiodic_job.h"
+
+// Constant Bandwidth Server parameters, passed to cbsServerTask() as pvParameters
+typedef struct {
+    AperiodicJobQueue *jobQueue;  // Source of AperiodicJob requests
+    TickType_t budget;        // Maximum budget Qs in ticks
+    TickType_t period;        // Server period Ts in ticks
+} CbsServerConfig;
+
+void cbsServerTask(void *pvParameters);
+void printCbsServerStats(void);
+
+#endif /* CBS_SERVER_H */
@@ -0,0 +1,6 @@
+// Task chains for task_sets/default.h
+// Period-triggered only: the stages have different periods, which
+// CHAIN_ACTIVATION_TRIGGERED rejects
+//
+// TASK_CHAIN(chain name, first stage, ..., last stage), stages named as in the task set table
+TASK_CHAIN("Pipeline", "Fast", "Medium", "Slow")
@@ -0,0 +1,6 @@
+// Task chains for task_sets/harmonic.h: sampling at 50 ms, filtering at
+// 100 ms and control at 200 ms. Period-triggered only: the stages have
+// different periods, which CHAIN_ACTIVATION_TRIGGERED rejects
+//
+// TASK_CHAIN(chain name, first stage, ..., last stage), stages named as in the task set table
+TASK_CHAIN("Control", "H50", "H100", "H200")
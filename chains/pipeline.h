@@ -0,0 +1,5 @@
+// Task chains for task_sets/pipeline.h: every stage has the 50 ms period of
+// the first, so the chain runs under both semantics
+//
+// TASK_CHAIN(chain name, first stage, ..., last stage), stages named as in the task set table
+TASK_CHAIN("Pipeline", "Sample", "Filter", "Control")
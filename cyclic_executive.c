@@ -0,0 +1,371 @@
+#include "cyclic_executive.h"
+#include "task_set.h"
+#include "hires_timer.h"
+#include "workload.h"
+#include "tiny_print.h"
+#include "CMSDK_CM3.h"
+#include "task.h"
+
+// A slice of a job in the static schedule
+typedef struct {
+    uint8_t taskIndex;       // Entry of periodicTasks
+    uint8_t last;            // The job completes with this slice
+    uint32_t computationUs;
+    uint32_t lagUs;          // From the job's release to the start of the slice's frame
+} CyclicSlice;
+
+// The slices of one minor frame, contiguous in cyclicSlices in run order
+typedef struct {
+    uint16_t firstSlice;
+    uint16_t sliceCount;
+} CyclicFrame;
+
+static CyclicFrame cyclicFrames[CYCLIC_MAX_FRAMES];
+static CyclicSlice cyclicSlices[CYCLIC_MAX_SLICES];
+static UBaseType_t frameCount = 0;  // 0 until a schedule is built
+static UBaseType_t jobCount = 0;
+static UBaseType_t sliceCount = 0;
+static uint32_t minorFrameMs = 0;
+static uint32_t majorFrameMs = 0;
+
+// Jobs and slices of one major frame while the schedule is built
+static uint8_t buildTask[CYCLIC_MAX_JOBS];
+static uint32_t buildReleaseMs[CYCLIC_MAX_JOBS];
+static uint32_t buildDeadlineMs[CYCLIC_MAX_JOBS];
+static uint16_t sliceJob[CYCLIC_MAX_SLICES];
+static uint32_t sliceFrame[CYCLIC_MAX_SLICES];     // Frame index, unwrapped
+static uint32_t sliceUs[CYCLIC_MAX_SLICES];
+static uint32_t frameLoadUs[CYCLIC_MAX_FRAMES];
+
+static TaskHandle_t dispatcherHandle = NULL;
+static volatile BaseType_t dispatching = pdFALSE;
+static volatile UBaseType_t currentFrame = 0;
+static volatile uint32_t framesDue = 0;          // Frame interrupts taken
+static volatile uint32_t frameStartCounts = 0;   // High resolution time the last frame expired
+static volatile uint32_t framesRun = 0;
+static volatile uint32_t frameOverruns = 0;
+static uint32_t framesTaken = 0;                  // framesDue up to the last frame dispatched
+static uint32_t framesSkipped = 0;                // Frames that expired while an earlier one ran
+static volatile uint32_t frameLatencyTotal = 0;  // High resolution counts from frame expiry to handler entry
+static volatile uint32_t frameLatencyMax = 0;
+static volatile uint32_t handlerCounts = 0;      // Frame handler time
+static volatile uint64_t dispatchCounts = 0;     // Dispatcher time outside the jobs' work
+static uint32_t jobsRun = 0;
+static uint32_t slicesRun = 0;
+static uint32_t taskJobs[MAX_PERIODIC_TASKS];
+static uint32_t taskMisses[MAX_PERIODIC_TASKS];
+static uint32_t taskMaxResponseUs[MAX_PERIODIC_TASKS];
+
+static uint32_t gcd(uint32_t a, uint32_t b)
+{
+    while (b != 0) {
+        uint32_t r = a % b;
+        a = b;
+        b = r;
+    }
+    return a;
+}
+
+// The jobs of one major frame, ordered by absolute deadline. A release that
+// the offset pushes past the major frame wraps to its start.
+static BaseType_t listJobs(void)
+{
+    jobCount = 0;
+    for (UBaseType_t i = 0; i < periodicTaskCount; ++i) {
+        const PeriodicTaskConfig *config = periodicTasks[i].config;
+        uint32_t deadlineMs = config->deadlineMs ? config->deadlineMs : config->periodMs;
+
+        for (uint32_t release = 0; release < majorFrameMs; release += config->periodMs) {
+            if (jobCount >= CYCLIC_MAX_JOBS) {
+                return pdFALSE;
+            }
+            buildTask[jobCount] = (uint8_t)i;
+            buildReleaseMs[jobCount] = (release + config->offsetMs) % majorFrameMs;
+            buildDeadlineMs[jobCount] = buildReleaseMs[jobCount] + deadlineMs;
+            jobCount++;
+        }
+    }
+
+    // Insertion sort; the table is built once at boot
+    for (UBaseType_t i = 1; i < jobCount; ++i) {
+        for (UBaseType_t j = i; j > 0 && buildDeadlineMs[j - 1] > buildDeadlineMs[j]; --j) {
+            uint8_t task = buildTask[j];
+            uint32_t release = buildReleaseMs[j];
+            uint32_t deadline = buildDeadlineMs[j];
+
+            buildTask[j] = buildTask[j - 1];
+            buildReleaseMs[j] = buildReleaseMs[j - 1];
+            buildDeadlineMs[j] = buildDeadlineMs[j - 1];
+            buildTask[j - 1] = task;
+            buildReleaseMs[j - 1] = release;
+            buildDeadlineMs[j - 1] = deadline;
+        }
+    }
+    return pdTRUE;
+}
+
+// Earliest-deadline-first, first-fit: each job fills the free room of the
+// frames that start after its release and end by its deadline, in order, and
+// is split into one slice per frame it uses. A job that fits one frame whole
+// is not split.
+static BaseType_t packJobs(uint32_t frameMs)
+{
+    UBaseType_t frames = majorFrameMs / frameMs;
+    uint32_t capacityUs = frameMs * 1000UL * (100 - CYCLIC_FRAME_MARGIN_PERCENT) / 100;
+
+    sliceCount = 0;
+    for (UBaseType_t k = 0; k < frames; ++k) {
+        frameLoadUs[k] = 0;
+    }
+    for (UBaseType_t j = 0; j < jobCount; ++j) {
+        uint32_t remainingUs = periodicTasks[buildTask[j]].computationUs;
+        uint32_t first = (buildReleaseMs[j] + frameMs - 1) / frameMs;
+        uint32_t last = buildDeadlineMs[j] / frameMs;  // First frame ending after the deadline
+
+        for (uint32_t k = first; k < last && remainingUs > 0; ++k) {
+            if (frameLoadUs[k % frames] + remainingUs <= capacityUs) {
+                first = k;
+                break;
+            }
+        }
+        for (uint32_t k = first; k < last && remainingUs > 0; ++k) {
+            uint32_t freeUs = capacityUs - frameLoadUs[k % frames];
+            uint32_t slice = remainingUs < freeUs ? remainingUs : freeUs;
+
+            if (slice == 0) {
+                continue;
+            }
+            if (sliceCount >= CYCLIC_MAX_SLICES) {
+                return pdFALSE;
+            }
+            sliceJob[sliceCount] = (uint16_t)j;
+            sliceFrame[sliceCount] = k;
+            sliceUs[sliceCount] = slice;
+            sliceCount++;
+            frameLoadUs[k % frames] += slice;
+            remainingUs -= slice;
+        }
+        if (remainingUs > 0) {
+            return pdFALSE;
+        }
+    }
+    return pdTRUE;
+}
+
+// Build the schedule from the task set table: the major frame is the
+// hyperperiod and the minor frame the largest divisor of it, within
+// CYCLIC_MAX_FRAMES frames, whose packing succeeds. Returns pdFALSE if there
+// is none within the table limits.
+BaseType_t cyclicExecutiveBuild(void)
+{
+    uint64_t hyperperiod = 1;
+
+    frameCount = 0;
+    for (UBaseType_t i = 0; i < periodicTaskCount; ++i) {
+        uint32_t periodMs = periodicTasks[i].config->periodMs;
+
+        hyperperiod = hyperperiod / gcd((uint32_t)hyperperiod, periodMs) * periodMs;
+        if (hyperperiod > 0xFFFFFFFFULL) {
+            printf("Cyclic schedule: major frame too long\n");
+            return pdFALSE;
+        }
+    }
+    majorFrameMs = (uint32_t)hyperperiod;
+
+    if (!listJobs()) {
+        printf("Cyclic schedule: more than %u jobs per major frame of %lu ms\n", CYCLIC_MAX_JOBS, majorFrameMs);
+        return pdFALSE;
+    }
+
+    for (uint32_t frameMs = majorFrameMs; frameMs > 0; --frameMs) {
+        if (majorFrameMs % frameMs != 0 || majorFrameMs / frameMs > CYCLIC_MAX_FRAMES || !packJobs(frameMs)) {
+            continue;
+        }
+
+        // Lay the slices out frame by frame, keeping the deadline order within a frame
+        UBaseType_t frames = majorFrameMs / frameMs;
+        UBaseType_t next = 0;
+
+        for (UBaseType_t k = 0; k < frames; ++k) {
+            cyclicFrames[k].firstSlice = (uint16_t)next;
+            for (UBaseType_t i = 0; i < sliceCount; ++i) {
+                if (sliceFrame[i] % frames != k) {
+                    continue;
+                }
+                cyclicSlices[next].taskIndex = buildTask[sliceJob[i]];
+                cyclicSlices[next].last = i + 1 == sliceCount || sliceJob[i + 1] != sliceJob[i];
+                cyclicSlices[next].computationUs = sliceUs[i];
+                cyclicSlices[next].lagUs = (sliceFrame[i] * frameMs - buildReleaseMs[sliceJob[i]]) * 1000UL;
+                next++;
+            }
+            cyclicFrames[k].sliceCount = (uint16_t)(next - cyclicFrames[k].firstSlice);
+        }
+        minorFrameMs = frameMs;
+        frameCount = frames;
+        printf("Cyclic schedule: minor frame %lu ms, major frame %lu ms, %lu frames, %lu jobs in %lu slices\n",
+               minorFrameMs, majorFrameMs, frameCount, jobCount, sliceCount);
+        return pdTRUE;
+    }
+
+    printf("Cyclic schedule: no feasible minor frame for a major frame of %lu ms\n", majorFrameMs);
+    return pdFALSE;
+}
+
+// Minor frame interrupt: note the frame's start and wake the dispatcher. The
+// timer counts at the same clock as hiresNow(), so LOAD - VALUE is the time
+// since the frame expired.
+static void cyclicFrameHandler(void)
+{
+    uint32_t entryCounts = hiresNow();
+    uint32_t sinceExpiry = CMSDK_DUALTIMER2->TimerLoad - CMSDK_DUALTIMER2->TimerValue;
+    BaseType_t higherPriorityTaskWoken = pdFALSE;
+
+    CMSDK_DUALTIMER2->TimerIntClr = CMSDK_DUALTIMER2_INTCLR_Msk;
+    if (!dispatching) {
+        return;
+    }
+
+    frameStartCounts = entryCounts - sinceExpiry;
+    framesDue++;
+    frameLatencyTotal += sinceExpiry;
+    if (sinceExpiry > frameLatencyMax) {
+        frameLatencyMax = sinceExpiry;
+    }
+    vTaskNotifyGiveFromISR(dispatcherHandle, &higherPriorityTaskWoken);
+    handlerCounts += hiresNow() - entryCounts;
+    portYIELD_FROM_ISR(higherPriorityTaskWoken);
+}
+
+// Dispatcher: run each frame's jobs to completion in table order. A frame
+// whose jobs end after the next frame expired is an overrun. The dispatcher
+// then runs the frame of the latest expiry, late, and the frames that expired
+// before it are skipped, so the table index stays with the wall-clock frame
+// and each response is measured from its own frame's start.
+static void cyclicDispatcherTask(void *parameters)
+{
+    (void)parameters;
+
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (!dispatching) {
+            continue;
+        }
+
+        uint32_t frameStart;
+        uint32_t due;
+
+        taskENTER_CRITICAL();
+        {
+            frameStart = frameStartCounts;
+            due = framesDue;
+        }
+        taskEXIT_CRITICAL();
+        if (due == framesTaken) {
+            // The expiry of this notification was already taken with the last frame
+            continue;
+        }
+
+        uint32_t skipped = due - framesTaken - 1;
+        framesTaken = due;
+        framesSkipped += skipped;
+        currentFrame = (currentFrame + skipped) % frameCount;
+
+        uint32_t previousEnd = hiresNow();
+        const CyclicFrame *frame = &cyclicFrames[currentFrame];
+
+        for (UBaseType_t i = 0; i < frame->sliceCount; ++i) {
+            const CyclicSlice *slice = &cyclicSlices[frame->firstSlice + i];
+            const PeriodicTask *task = &periodicTasks[slice->taskIndex];
+
+            dispatchCounts += hiresNow() - previousEnd;
+            workloadRun(task->config->workload, slice->computationUs);
+            previousEnd = hiresNow();
+            slicesRun++;
+            if (!slice->last) {
+                continue;
+            }
+
+            uint32_t responseUs = hiresCountsToUs(previousEnd - frameStart) + slice->lagUs;
+            taskJobs[slice->taskIndex]++;
+            if (responseUs > task->deadline * US_PER_TICK) {
+                taskMisses[slice->taskIndex]++;
+            }
+            if (responseUs > taskMaxResponseUs[slice->taskIndex]) {
+                taskMaxResponseUs[slice->taskIndex] = responseUs;
+            }
+            jobsRun++;
+        }
+        dispatchCounts += hiresNow() - previousEnd;
+
+        if (framesDue != due) {
+            frameOverruns++;
+        }
+        currentFrame = (currentFrame + 1) % frameCount;
+        framesRun++;
+    }
+}
+
+// Create the dispatcher at the top priority and start DUALTIMER2 in periodic
+// mode at the minor frame. The frame interrupt sits one level above SysTick
+// and PendSV, which share the lowest level, but only wakes the dispatcher, so
+// the tick is never held off for a frame's jobs; the dispatcher task is
+// preempted by the tick like any other. The interrupt stays masked until the
+// scheduler starts.
+void cyclicExecutiveStart(void)
+{
+    if (frameCount == 0) {
+        return;
+    }
+    if (xTaskCreate(cyclicDispatcherTask, "CyclicDispatcher", configMINIMAL_STACK_SIZE * 2, NULL,
+                    CYCLIC_DISPATCHER_PRIORITY, &dispatcherHandle) != pdPASS) {
+        printf("Cyclic schedule: dispatcher task not created\n");
+        return;
+    }
+
+    CMSDK_DUALTIMER2->TimerControl = 0;
+    CMSDK_DUALTIMER2->TimerIntClr = CMSDK_DUALTIMER2_INTCLR_Msk;
+    CMSDK_DUALTIMER2->TimerLoad = hiresUsToCounts(minorFrameMs * 1000UL) - 1;
+    dispatching = pdTRUE;
+    hiresSetDualTimer2Handler(cyclicFrameHandler);
+    CMSDK_DUALTIMER2->TimerControl = CMSDK_DUALTIMER2_CTRL_EN_Msk | CMSDK_DUALTIMER2_CTRL_MODE_Msk |
+                                     CMSDK_DUALTIMER2_CTRL_INTEN_Msk | CMSDK_DUALTIMER2_CTRL_SIZE_Msk;
+
+    NVIC_SetPriority(DUALTIMER_IRQn, configLIBRARY_LOWEST_INTERRUPT_PRIORITY - 1);
+    NVIC_EnableIRQ(DUALTIMER_IRQn);
+}
+
+// Stops the dispatch, then reports. The overhead is the frame handler and
+// dispatcher time spent outside the jobs' work plus the latency from each
+// frame's timer expiry to the handler entry. The two context switches per
+// frame, into the dispatcher and back to idle, are in the kernel dispatch
+// time of the Latency Overhead Report; no job is ever context switched.
+void printCyclicExecutiveReport(void)
+{
+    if (frameCount == 0) {
+        return;
+    }
+    dispatching = pdFALSE;
+    CMSDK_DUALTIMER2->TimerControl = 0;
+
+    uint32_t frames = framesRun ? framesRun : 1;
+    uint32_t slices = slicesRun ? slicesRun : 1;
+
+    printf("\n==== Cyclic Executive ====\n");
+    printf("Minor Frame: %lu ms\n", minorFrameMs);
+    printf("Major Frame: %lu ms\n", majorFrameMs);
+    printf("Frames Run: %lu\n", framesRun);
+    printf("Frame Overruns: %lu\n", frameOverruns);
+    printf("Frames Skipped: %lu\n", framesSkipped);
+    printf("Jobs Run: %lu\n", jobsRun);
+    printf("Slices Run: %lu\n", slicesRun);
+    printf("Mean Frame Latency (ns): %lu\n", hiresCountsToNs(frameLatencyTotal / frames));
+    printf("Max Frame Latency (ns): %lu\n", hiresCountsToNs(frameLatencyMax));
+    printf("Mean Dispatch per Slice (ns): %lu\n", hiresCountsToNs((uint32_t)(dispatchCounts / slices)));
+    printf("Dispatch Overhead (us): %lu\n", hiresCountsToUs((uint32_t)dispatchCounts + handlerCounts + frameLatencyTotal));
+
+    printf("Task,Jobs,Misses,Max Response (us)\n");
+    for (UBaseType_t i = 0; i < periodicTaskCount; ++i) {
+        printf("\"%s\",%lu,%lu,%lu\n", periodicTasks[i].config->name, taskJobs[i], taskMisses[i],
+               taskMaxResponseUs[i]);
+    }
+}
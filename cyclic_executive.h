@@ -0,0 +1,24 @@
+#ifndef CYCLIC_EXECUTIVE_H
+#define CYCLIC_EXECUTIVE_H
+
+#include "FreeRTOS.h"
+
+// Time-triggered cyclic executive for the periodic task set table. A static
+// schedule of minor frames, repeating every major frame (the hyperperiod), is
+// built from the table at boot. The CMSDK DUALTIMER2 interrupt marks each
+// minor frame and wakes a dispatcher task at the top priority, which runs the
+// frame's job slices in table order; a job too long for the room left in one
+// frame is split across frames. No task is created, readied or switched for
+// the jobs. The kernel keeps only its tick, the dispatcher and the idle task,
+// which prints the final report.
+#define CYCLIC_MAX_FRAMES            512   // Minor frames per major frame
+#define CYCLIC_MAX_JOBS              1024  // Jobs per major frame
+#define CYCLIC_MAX_SLICES            2048  // Job slices per major frame
+#define CYCLIC_FRAME_MARGIN_PERCENT  5     // Share of each frame left free for the dispatch and the tick interrupt
+#define CYCLIC_DISPATCHER_PRIORITY   ( configMAX_PRIORITIES - 1 )
+
+BaseType_t cyclicExecutiveBuild(void);
+void cyclicExecutiveStart(void);
+void printCyclicExecutiveReport(void);
+
+#endif /* CYCLIC_EXECUTIVE_H */
@@ -0,0 +1,226 @@
+#include "deadline_monitor.h"
+#include "tiny_print.h"
+#include <task.h>
+#include <timers.h>
+
+// Deadline bookkeeping for one periodic task
+typedef struct {
+    BaseType_t registered;
+    UBaseType_t policy;
+    TickType_t relativeDeadline;
+    TimerHandle_t watchdog;        // One-shot timer armed at each absolute deadline, NULL if unused
+
+    // State of the current job
+    BaseType_t jobActive;
+    BaseType_t missDetected;
+    BaseType_t abortRequested;
+    BaseType_t skipNext;
+    BaseType_t degradeNext;
+
+    // Counters for the final report
+    uint32_t jobs;
+    uint32_t misses;
+    uint32_t watchdogDetections;
+    uint32_t skipped;
+    uint32_t aborted;
+    uint32_t degraded;
+    TickType_t maxLateness;
+} MonitoredTask;
+
+static MonitoredTask monitored[MAX_TASKS];
+
+static const char *policyName(UBaseType_t policy)
+{
+    switch (policy) {
+        case MISS_POLICY_SKIP_NEXT: return "Skip Next";
+        case MISS_POLICY_ABORT:     return "Abort";
+        case MISS_POLICY_DEGRADE:   return "Degrade";
+        default:                    return "Log";
+    }
+}
+
+// Mark the running job as late; returns pdTRUE if this is the first detection
+static BaseType_t flagMiss(MonitoredTask *task)
+{
+    BaseType_t firstDetection = pdFALSE;
+
+    taskENTER_CRITICAL();
+    {
+        if (task->jobActive && !task->missDetected) {
+            task->missDetected = pdTRUE;
+            task->misses++;
+            if (task->policy == MISS_POLICY_ABORT) {
+                task->abortRequested = pdTRUE;
+            }
+            firstDetection = pdTRUE;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return firstDetection;
+}
+
+// Runs in the timer service task when a job is still active at its deadline
+static void watchdogCallback(TimerHandle_t xTimer)
+{
+    int taskId = (int)(intptr_t)pvTimerGetTimerID(xTimer);
+
+    if (flagMiss(&monitored[taskId])) {
+        monitored[taskId].watchdogDetections++;
+    }
+}
+
+void deadlineMonitorRegister(int taskId, TickType_t relativeDeadline, UBaseType_t policy, BaseType_t useWatchdog)
+{
+    if (taskId < 0 || taskId >= MAX_TASKS) {
+        printf("Deadline monitor registration failed: ID=%d\n", taskId);
+        configASSERT(0);
+        return;
+    }
+
+    MonitoredTask *task = &monitored[taskId];
+    task->registered = pdTRUE;
+    task->policy = policy;
+    task->relativeDeadline = relativeDeadline;
+    task->watchdog = NULL;
+
+    if (useWatchdog) {
+        task->watchdog = xTimerCreate("Deadline", relativeDeadline, pdFALSE, (void *)(intptr_t)taskId, watchdogCallback);
+        configASSERT(task->watchdog != NULL);
+    }
+}
+
+// Have the next job skipped or degraded, as after a miss under
+// MISS_POLICY_SKIP_NEXT or MISS_POLICY_DEGRADE; a pending miss policy is kept
+void deadlineSetNextJob(int taskId, BaseType_t skip, BaseType_t degraded)
+{
+    MonitoredTask *task = &monitored[taskId];
+
+    taskENTER_CRITICAL();
+    {
+        task->skipNext = task->skipNext || skip;
+        task->degradeNext = task->degradeNext || degraded;
+    }
+    taskEXIT_CRITICAL();
+}
+
+// Open a job released at releaseTime, applying any policy left over from a previous miss
+PeriodicJob deadlineJobBegin(int taskId, TickType_t releaseTime)
+{
+    MonitoredTask *task = &monitored[taskId];
+    PeriodicJob job = {
+        .taskId = taskId,
+        .releaseTime = releaseTime,
+        .absoluteDeadline = releaseTime + task->relativeDeadline,
+        .skip = pdFALSE,
+        .degraded = pdFALSE
+    };
+
+    if (!task->registered) {
+        return job;
+    }
+
+    taskENTER_CRITICAL();
+    {
+        job.skip = task->skipNext;
+        job.degraded = task->degradeNext;
+        task->skipNext = pdFALSE;
+        task->degradeNext = pdFALSE;
+        task->jobActive = !job.skip;
+        task->missDetected = pdFALSE;
+        task->abortRequested = pdFALSE;
+        task->jobs++;
+    }
+    taskEXIT_CRITICAL();
+
+    if (job.skip) {
+        task->skipped++;
+        return job;
+    }
+    if (job.degraded) {
+        task->degraded++;
+    }
+
+    if (task->watchdog != NULL) {
+        TickType_t now = xTaskGetTickCount();
+
+        if ((int32_t)(job.absoluteDeadline - now) > 0) {
+            xTimerChangePeriod(task->watchdog, job.absoluteDeadline - now, 0);
+        } else {
+            // Released so late that the deadline has already passed
+            flagMiss(task);
+        }
+    }
+
+    return job;
+}
+
+// Polled by the job body between units of work
+BaseType_t deadlineJobAborted(const PeriodicJob *job)
+{
+    return monitored[job->taskId].abortRequested;
+}
+
+// Close a job; returns pdTRUE if it missed its deadline
+BaseType_t deadlineJobEnd(const PeriodicJob *job, TickType_t completionTime)
+{
+    MonitoredTask *task = &monitored[job->taskId];
+    BaseType_t missed;
+
+    if (!task->registered || job->skip) {
+        return pdFALSE;
+    }
+
+    if (task->watchdog != NULL) {
+        xTimerStop(task->watchdog, 0);
+    }
+
+    if ((int32_t)(completionTime - job->absoluteDeadline) > 0) {
+        TickType_t lateness = completionTime - job->absoluteDeadline;
+
+        flagMiss(task);
+        if (lateness > task->maxLateness) {
+            task->maxLateness = lateness;
+        }
+    }
+
+    taskENTER_CRITICAL();
+    {
+        missed = task->missDetected;
+        task->jobActive = pdFALSE;
+        if (missed) {
+            task->skipNext = task->policy == MISS_POLICY_SKIP_NEXT;
+            task->degradeNext = task->policy == MISS_POLICY_DEGRADE;
+            if (task->abortRequested) {
+                task->aborted++;
+            }
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return missed;
+}
+
+void printDeadlineMisses(void)
+{
+    printf("\n==== Deadline Misses ====\n");
+    printf("Task,Policy,Jobs,Misses,Watchdog Detections,Max Lateness (ticks),Skipped,Aborted,Degraded\n");
+
+    for (UBaseType_t i = 0; i < MAX_TASKS; ++i) {
+        const MonitoredTask *task = &monitored[i];
+
+        if (!task->registered) {
+            continue;
+        }
+        printf("\"%s\",%s,%lu,%lu,%lu,%lu,%lu,%lu,%lu\n",
+               taskInfo[i].taskName,
+               policyName(task->policy),
+               task->jobs,
+               task->misses,
+               task->watchdogDetections,
+               task->maxLateness,
+               task->skipped,
+               task->aborted,
+               task->degraded);
+    }
+}
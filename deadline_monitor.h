@@ -0,0 +1,29 @@
+#ifndef DEADLINE_MONITOR_H
+#define DEADLINE_MONITOR_H
+
+#include "FreeRTOS.h"
+#include "trace_task_switch.h"
+
+// What happens after a job misses its deadline
+#define MISS_POLICY_LOG        0  // Count and log the miss only
+#define MISS_POLICY_SKIP_NEXT  1  // Skip the next job of the task
+#define MISS_POLICY_ABORT      2  // Abort the late job at its deadline
+#define MISS_POLICY_DEGRADE    3  // Run the next job with its lighter computation
+
+// A periodic job as seen by the monitor
+typedef struct {
+    int taskId;
+    TickType_t releaseTime;
+    TickType_t absoluteDeadline;
+    BaseType_t skip;          // Job dropped by MISS_POLICY_SKIP_NEXT
+    BaseType_t degraded;      // Job should run its lighter computation
+} PeriodicJob;
+
+void deadlineMonitorRegister(int taskId, TickType_t relativeDeadline, UBaseType_t policy, BaseType_t useWatchdog);
+void deadlineSetNextJob(int taskId, BaseType_t skip, BaseType_t degraded);
+PeriodicJob deadlineJobBegin(int taskId, TickType_t releaseTime);
+BaseType_t deadlineJobAborted(const PeriodicJob *job);
+BaseType_t deadlineJobEnd(const PeriodicJob *job, TickType_t completionTime);
+void printDeadlineMisses(void);
+
+#endif /* DEADLINE_MONITOR_H */
@@ -0,0 +1,171 @@
+#include "dual_priority.h"
+#include "task_set.h"
+#include "tiny_print.h"
+#include <timers.h>
+
+// Bands and promotion state of one periodic task
+typedef struct {
+    TaskHandle_t handle;
+    UBaseType_t lowPriority;
+    UBaseType_t highPriority;
+    UBaseType_t assigned;        // Band priority, applied unless a ceiling holds the task higher
+    TickType_t promotion;        // Promotion point U = D - R after each release
+    TimerHandle_t timer;         // One-shot timer armed at the promotion point of the next job
+    BaseType_t promotedThisJob;
+
+    uint32_t jobs;
+    uint32_t promotedJobs;
+} DualTask;
+
+static DualTask dualTasks[MAX_TASKS];
+
+// Move the periodic tasks into the upper band and give each a lower band
+// priority. When both bands fit, the lower band keeps the rate monotonic order;
+// otherwise all jobs share one lower level and rotate by time slicing. Returns
+// the priority of the aperiodic server, between the two bands. Call after
+// taskSetLoad() and before the tasks are created.
+UBaseType_t dualPriorityLayout(void)
+{
+    UBaseType_t levels = 0;
+
+    for (UBaseType_t i = 0; i < periodicTaskCount; ++i) {
+        if (periodicTasks[i].priority - PERIODIC_LOWEST_PRIORITY + 1 > levels) {
+            levels = periodicTasks[i].priority - PERIODIC_LOWEST_PRIORITY + 1;
+        }
+    }
+
+    UBaseType_t lowLevels = PERIODIC_LOWEST_PRIORITY + 2 * levels <= DUAL_HIGHEST_PRIORITY ? levels : 1;
+    UBaseType_t serverPriority = PERIODIC_LOWEST_PRIORITY + lowLevels;
+
+    configASSERT(serverPriority + levels <= DUAL_HIGHEST_PRIORITY);
+    for (UBaseType_t i = 0; i < periodicTaskCount; ++i) {
+        PeriodicTask *task = &periodicTasks[i];
+        DualTask *dual = &dualTasks[task->taskId];
+
+        dual->lowPriority = lowLevels == levels ? task->priority : PERIODIC_LOWEST_PRIORITY;
+        dual->highPriority = serverPriority + 1 + (task->priority - PERIODIC_LOWEST_PRIORITY);
+        dual->assigned = dual->lowPriority;
+        task->priority = dual->highPriority;
+    }
+    return serverPriority;
+}
+
+// Priority to create a task with: the lower band
+UBaseType_t dualPriorityLow(int taskId)
+{
+    return dualTasks[taskId].lowPriority;
+}
+
+// Runs in the timer service task at a job's promotion point
+static void promotionCallback(TimerHandle_t xTimer)
+{
+    DualTask *dual = &dualTasks[(int)(intptr_t)pvTimerGetTimerID(xTimer)];
+
+    vTaskSuspendAll();
+    {
+        // A task above its band priority holds a ceiling; the resource layer
+        // applies the promotion when it releases it
+        BaseType_t raised = uxTaskPriorityGet(dual->handle) != dual->assigned;
+
+        dual->assigned = dual->highPriority;
+        dual->promotedThisJob = pdTRUE;
+        if (!raised) {
+            vTaskPrioritySet(dual->handle, dual->highPriority);
+        }
+    }
+    xTaskResumeAll();
+}
+
+// Arm the promotion of the first job from its worst-case response time in the
+// upper band; an unschedulable task is promoted for good. Call before
+// vTaskStartScheduler(), once the response-time analysis has run.
+void dualPriorityStart(int taskId, TaskHandle_t handle, TickType_t responseTime, TickType_t deadline,
+                       TickType_t firstRelease)
+{
+    DualTask *dual = &dualTasks[taskId];
+
+    dual->handle = handle;
+    dual->promotion = responseTime < deadline ? deadline - responseTime : 0;
+    dual->timer = xTimerCreate("Promotion", 1, pdFALSE, (void *)(intptr_t)taskId, promotionCallback);
+    configASSERT(dual->timer != NULL);
+
+    if (firstRelease + dual->promotion > 0) {
+        xTimerChangePeriod(dual->timer, firstRelease + dual->promotion, 0);
+    } else {
+        dual->assigned = dual->highPriority;
+        dual->promotedThisJob = pdTRUE;
+        vTaskPrioritySet(handle, dual->highPriority);
+    }
+}
+
+// Called by a periodic task when its job ends: arm the promotion of the next
+// job and return to the lower band, unless that promotion point has passed
+// already. The timer is armed first, so a task preempted in between is
+// promoted in time; the band is then chosen with the scheduler suspended, so
+// the promotion cannot fire between the check and the priority change.
+void dualPriorityJobEnd(int taskId, TickType_t nextRelease)
+{
+    DualTask *dual = &dualTasks[taskId];
+    TickType_t promotionTime = nextRelease + dual->promotion;
+    TickType_t now = xTaskGetTickCount();
+
+    dual->jobs++;
+    if (dual->promotedThisJob) {
+        dual->promotedJobs++;
+    }
+    dual->promotedThisJob = pdFALSE;
+
+    if ((int32_t)(promotionTime - now) > 0) {
+        xTimerChangePeriod(dual->timer, promotionTime - now, portMAX_DELAY);
+    }
+
+    vTaskSuspendAll();
+    {
+        if ((int32_t)(promotionTime - xTaskGetTickCount()) > 0) {
+            dual->assigned = dual->lowPriority;
+        } else {
+            // The next job is late already: it starts promoted
+            dual->assigned = dual->highPriority;
+            dual->promotedThisJob = pdTRUE;
+        }
+        vTaskPrioritySet(NULL, dual->assigned);
+    }
+    xTaskResumeAll();
+}
+
+// Band priority of a task, or fallback if it is not scheduled by dual priority
+UBaseType_t dualPriorityAssigned(TaskHandle_t handle, UBaseType_t fallback)
+{
+    UBaseType_t priority = fallback;
+
+    vTaskSuspendAll();
+    {
+        for (UBaseType_t i = 0; i < MAX_TASKS; ++i) {
+            if (dualTasks[i].handle != NULL && dualTasks[i].handle == handle) {
+                priority = dualTasks[i].assigned;
+                break;
+            }
+        }
+    }
+    xTaskResumeAll();
+
+    return priority;
+}
+
+// Jobs that completed in the lower band never delayed an aperiodic job
+void printDualPriorityReport(void)
+{
+    printf("\n==== Dual Priority ====\n");
+    printf("Task,Low Priority,High Priority,Promotion (ticks),Jobs,Promoted Jobs,Promoted (%%)\n");
+
+    for (UBaseType_t i = 0; i < MAX_TASKS; ++i) {
+        const DualTask *dual = &dualTasks[i];
+
+        if (dual->handle == NULL) {
+            continue;
+        }
+        printf("\"%s\",%lu,%lu,%lu,%lu,%lu,%lu\n", taskInfo[i].taskName, dual->lowPriority, dual->highPriority,
+               dual->promotion, dual->jobs, dual->promotedJobs,
+               dual->jobs ? dual->promotedJobs * 100 / dual->jobs : 0);
+    }
+}
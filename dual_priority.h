@@ -0,0 +1,23 @@
+#ifndef DUAL_PRIORITY_H
+#define DUAL_PRIORITY_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "trace_task_switch.h"
+
+// Dual priority scheduling (Davis & Wellings). Every periodic job starts in a
+// lower band, below the aperiodic server, and a one-shot timer promotes it to
+// its rate monotonic priority in the upper band at the promotion point
+// U = D - R after its release, where R is its worst-case response time in the
+// upper band. Aperiodic work runs ahead of the periodic jobs until then.
+#define DUAL_HIGHEST_PRIORITY  ( SLACK_SERVER_PRIORITY - 1 )  // Top of the upper band
+
+UBaseType_t dualPriorityLayout(void);
+UBaseType_t dualPriorityLow(int taskId);
+void dualPriorityStart(int taskId, TaskHandle_t handle, TickType_t responseTime, TickType_t deadline,
+                       TickType_t firstRelease);
+void dualPriorityJobEnd(int taskId, TickType_t nextRelease);
+UBaseType_t dualPriorityAssigned(TaskHandle_t handle, UBaseType_t fallback);
+void printDualPriorityReport(void);
+
+#endif /* DUAL_PRIORITY_H */
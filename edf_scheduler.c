@@ -0,0 +1,106 @@
+#include "edf_scheduler.h"
+#include "tiny_print.h"
+
+typedef struct {
+    TaskHandle_t handle;
+    TickType_t deadline;      // Absolute deadline of the current job
+    UBaseType_t priority;     // Priority last handed out by the dispatcher
+} EdfTask;
+
+static EdfTask edfTasks[MAX_EDF_TASKS];
+static UBaseType_t edfTaskCount = 0;
+
+// Wrap-safe "a is earlier than b" for tick values
+static BaseType_t deadlineBefore(TickType_t a, TickType_t b)
+{
+    return (int32_t)(a - b) < 0;
+}
+
+// Rank every registered task by deadline and map the rank onto the priority band.
+// Ties keep registration order so equal deadlines never share a priority.
+static void reassignPriorities(void)
+{
+    for (UBaseType_t i = 0; i < edfTaskCount; ++i) {
+        UBaseType_t rank = 0;
+
+        for (UBaseType_t j = 0; j < edfTaskCount; ++j) {
+            if (j == i) {
+                continue;
+            }
+            if (deadlineBefore(edfTasks[j].deadline, edfTasks[i].deadline) ||
+                (edfTasks[j].deadline == edfTasks[i].deadline && j < i)) {
+                rank++;
+            }
+        }
+
+        UBaseType_t newPriority = EDF_HIGHEST_PRIORITY - rank;
+        if (newPriority != edfTasks[i].priority) {
+            // A task running above its assigned priority is inside a ceiling-protected
+            // critical section; record the new rank and let the resource layer apply it
+            BaseType_t raised = uxTaskPriorityGet(edfTasks[i].handle) != edfTasks[i].priority;
+
+            edfTasks[i].priority = newPriority;
+            if (!raised) {
+                vTaskPrioritySet(edfTasks[i].handle, newPriority);
+            }
+        }
+    }
+}
+
+// Register a task with the dispatcher; call before vTaskStartScheduler()
+void edfRegisterTask(TaskHandle_t xTaskHandle, TickType_t absoluteDeadline)
+{
+    if (xTaskHandle == NULL || edfTaskCount >= MAX_EDF_TASKS) {
+        printf("EDF registration failed: Handle=%p, Count=%lu\n", (void *)xTaskHandle, edfTaskCount);
+        configASSERT(0);
+        return;
+    }
+
+    configASSERT(EDF_HIGHEST_PRIORITY >= edfTaskCount + 1);
+
+    edfTasks[edfTaskCount].handle = xTaskHandle;
+    edfTasks[edfTaskCount].deadline = absoluteDeadline;
+    edfTasks[edfTaskCount].priority = uxTaskPriorityGet(xTaskHandle);
+    edfTaskCount++;
+
+    reassignPriorities();
+}
+
+// Publish the absolute deadline of the job the task is about to run.
+// A task waking for a new job still holds its previous deadline, which can be
+// no later than the current time, so it is always dispatched promptly enough
+// to publish the new one.
+void edfSetDeadline(TaskHandle_t xTaskHandle, TickType_t absoluteDeadline)
+{
+    vTaskSuspendAll();
+    {
+        for (UBaseType_t i = 0; i < edfTaskCount; ++i) {
+            if (edfTasks[i].handle == xTaskHandle) {
+                edfTasks[i].deadline = absoluteDeadline;
+                reassignPriorities();
+                break;
+            }
+        }
+    }
+    xTaskResumeAll();
+}
+
+// Priority the dispatcher currently assigns to a task, or fallback if the task
+// is not scheduled by EDF
+UBaseType_t edfGetAssignedPriority(TaskHandle_t xTaskHandle, UBaseType_t fallback)
+{
+    UBaseType_t priority = fallback;
+
+    vTaskSuspendAll();
+    {
+        for (UBaseType_t i = 0; i < edfTaskCount; ++i) {
+            if (edfTasks[i].handle == xTaskHandle) {
+                priority = edfTasks[i].priority;
+                break;
+            }
+        }
+    }
+    xTaskResumeAll();
+
+    return priority;
+}
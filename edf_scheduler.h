@@ -0,0 +1,19 @@
+#ifndef EDF_SCHEDULER_H
+#define EDF_SCHEDULER_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "trace_task_switch.h"
+
+#define MAX_EDF_TASKS ( MAX_PERIODIC_TASKS + 1 )  // Every periodic task plus the CBS
+
+// FreeRTOS only schedules by fixed priority, so EDF is layered on top by
+// handing out the priority band [EDF_HIGHEST_PRIORITY - n + 1, EDF_HIGHEST_PRIORITY]
+// to the n registered tasks in order of their absolute deadlines.
+#define EDF_HIGHEST_PRIORITY PERIODIC_HIGHEST_PRIORITY
+
+void edfRegisterTask(TaskHandle_t xTaskHandle, TickType_t absoluteDeadline);
+void edfSetDeadline(TaskHandle_t xTaskHandle, TickType_t absoluteDeadline);
+UBaseType_t edfGetAssignedPriority(TaskHandle_t xTaskHandle, UBaseType_t fallback);
+
+#endif /* EDF_SCHEDULER_H */
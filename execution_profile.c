@@ -0,0 +1,88 @@
+#include "execution_profile.h"
+#include "workload.h"
+#include "tiny_print.h"
+
+// Execution time distribution of the jobs of one periodic task
+typedef struct {
+    BaseType_t registered;
+    uint32_t wcetUs;
+    UBaseType_t workload;
+    uint32_t jobs;
+    uint32_t minUs;
+    uint32_t maxUs;
+    uint64_t totalUs;
+    uint32_t histogram[EXECUTION_HISTOGRAM_BUCKETS];
+} ExecutionProfile;
+
+static ExecutionProfile profiles[MAX_TASKS];
+
+void executionProfileRegister(int taskId, uint32_t wcetUs, UBaseType_t workload)
+{
+    if (taskId < 0 || taskId >= MAX_TASKS || wcetUs == 0) {
+        printf("Execution profile registration failed: ID=%d\n", taskId);
+        configASSERT(0);
+        return;
+    }
+
+    ExecutionProfile *profile = &profiles[taskId];
+    profile->registered = pdTRUE;
+    profile->wcetUs = wcetUs;
+    profile->workload = workload;
+    profile->minUs = UINT32_MAX;
+}
+
+// Record the execution time a job actually consumed, measured on the task's
+// execution clock
+void executionProfileRecord(int taskId, uint32_t executionUs)
+{
+    if (taskId < 0 || taskId >= MAX_TASKS || !profiles[taskId].registered) {
+        return;
+    }
+
+    ExecutionProfile *profile = &profiles[taskId];
+    uint32_t bucket = (uint32_t)(((uint64_t)executionUs * 10) / profile->wcetUs);
+
+    if (bucket >= EXECUTION_HISTOGRAM_BUCKETS) {
+        bucket = EXECUTION_HISTOGRAM_BUCKETS - 1;
+    }
+    profile->histogram[bucket]++;
+    profile->jobs++;
+    profile->totalUs += executionUs;
+    if (executionUs < profile->minUs) {
+        profile->minUs = executionUs;
+    }
+    if (executionUs > profile->maxUs) {
+        profile->maxUs = executionUs;
+    }
+}
+
+void printExecutionProfile(void)
+{
+    printf("\n==== Execution Time Distribution ====\n");
+    printf("Task,Workload,WCET (us),Jobs,Min (us),Mean (us),Max (us),Max/WCET (%%)");
+    for (int bucket = 0; bucket < EXECUTION_HISTOGRAM_BUCKETS - 1; ++bucket) {
+        printf(",<%d%%", (bucket + 1) * 10);
+    }
+    printf(",>=%d%%\n", (EXECUTION_HISTOGRAM_BUCKETS - 1) * 10);
+
+    for (UBaseType_t i = 0; i < MAX_TASKS; ++i) {
+        const ExecutionProfile *profile = &profiles[i];
+
+        if (!profile->registered || profile->jobs == 0) {
+            continue;
+        }
+        printf("\"%s\",%s,%lu,%lu,%lu,%lu,%lu,%lu",
+               taskInfo[i].taskName,
+               workloadName(profile->workload),
+               profile->wcetUs,
+               profile->jobs,
+               profile->minUs,
+               (uint32_t)(profile->totalUs / profile->jobs),
+               profile->maxUs,
+               (uint32_t)(((uint64_t)profile->maxUs * 100) / profile->wcetUs));
+        for (int bucket = 0; bucket < EXECUTION_HISTOGRAM_BUCKETS; ++bucket) {
+            printf(",%lu", profile->histogram[bucket]);
+        }
+        printf("\n");
+    }
+}
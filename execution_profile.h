@@ -0,0 +1,15 @@
+#ifndef EXECUTION_PROFILE_H
+#define EXECUTION_PROFILE_H
+
+#include "FreeRTOS.h"
+#include "trace_task_switch.h"
+
+// Per-job execution times are binned in steps of 10% of the task's WCET;
+// the last bucket collects everything from 150% up
+#define EXECUTION_HISTOGRAM_BUCKETS 16
+
+void executionProfileRegister(int taskId, uint32_t wcetUs, UBaseType_t workload);
+void executionProfileRecord(int taskId, uint32_t executionUs);
+void printExecutionProfile(void);
+
+#endif /* EXECUTION_PROFILE_H */
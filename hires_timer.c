@@ -0,0 +1,77 @@
+#include "hires_timer.h"
+#include "CMSDK_CM3.h"
+#include "tiny_print.h"
+
+#define HIRES_CALIBRATION_CYCLES 1000000UL  // CPU cycles measured at boot
+
+static uint32_t countsPerMs = 1;  // Timer counts per millisecond of kernel time
+static void (*dualTimer2Handler)(void) = NULL;
+
+// Start the counter and calibrate it against SysTick. SysTick counts CPU cycles
+// at configCPU_CLOCK_HZ, the same clock the kernel derives its tick from, so
+// microseconds measured with this timer agree with the tick. Must run before
+// vTaskStartScheduler(), which reprograms SysTick for the tick interrupt.
+void hiresTimerInit(void)
+{
+    CMSDK_DUALTIMER1->TimerControl = 0;
+    CMSDK_DUALTIMER1->TimerLoad = 0xFFFFFFFFUL;
+    // Free-running, 32-bit, no prescaler, no interrupt
+    CMSDK_DUALTIMER1->TimerControl = CMSDK_DUALTIMER1_CTRL_EN_Msk | CMSDK_DUALTIMER1_CTRL_SIZE_Msk;
+
+    SysTick->CTRL = 0;
+    SysTick->LOAD = SysTick_LOAD_RELOAD_Msk;
+    SysTick->VAL = 0;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+
+    uint32_t startCycles = SysTick->VAL;
+    uint32_t startCounts = hiresNow();
+    uint32_t elapsedCycles;
+
+    do {
+        // SysTick counts down through a 24-bit range, which the interval never exceeds
+        elapsedCycles = (startCycles - SysTick->VAL) & SysTick_LOAD_RELOAD_Msk;
+    } while (elapsedCycles < HIRES_CALIBRATION_CYCLES);
+
+    uint32_t elapsedCounts = hiresNow() - startCounts;
+    SysTick->CTRL = 0;
+
+    countsPerMs = (uint32_t)(((uint64_t)elapsedCounts * configCPU_CLOCK_HZ) / ((uint64_t)elapsedCycles * 1000));
+    if (countsPerMs == 0) {
+        countsPerMs = 1;
+    }
+    printf("High resolution timer: %lu counts per ms\n", countsPerMs);
+}
+
+uint32_t hiresNow(void)
+{
+    return 0xFFFFFFFFUL - CMSDK_DUALTIMER1->TimerValue;
+}
+
+uint32_t hiresCountsToUs(uint32_t counts)
+{
+    return (uint32_t)(((uint64_t)counts * 1000) / countsPerMs);
+}
+
+uint32_t hiresUsToCounts(uint32_t microseconds)
+{
+    return (uint32_t)(((uint64_t)microseconds * countsPerMs) / 1000);
+}
+
+uint32_t hiresCountsToNs(uint32_t counts)
+{
+    return (uint32_t)(((uint64_t)counts * 1000000) / countsPerMs);
+}
+
+void hiresSetDualTimer2Handler(void (*handler)(void))
+{
+    dualTimer2Handler = handler;
+}
+
+void DUALTIMER_Handler(void)
+{
+    if (dualTimer2Handler != NULL) {
+        dualTimer2Handler();
+    } else {
+        CMSDK_DUALTIMER2->TimerIntClr = CMSDK_DUALTIMER2_INTCLR_Msk;
+    }
+}
@@ -0,0 +1,20 @@
+#ifndef HIRES_TIMER_H
+#define HIRES_TIMER_H
+
+#include "FreeRTOS.h"
+
+// Free-running 32-bit up-counter on CMSDK DUALTIMER1 for sub-tick timing.
+// Differences of two readings are valid as long as the interval is shorter
+// than one wrap of the counter (about 170 s at 25 MHz).
+void hiresTimerInit(void);
+uint32_t hiresNow(void);
+uint32_t hiresCountsToUs(uint32_t counts);
+uint32_t hiresUsToCounts(uint32_t microseconds);
+uint32_t hiresCountsToNs(uint32_t counts);
+
+// DUALTIMER1 and DUALTIMER2 share one interrupt line. DUALTIMER1 never
+// interrupts; the one user of DUALTIMER2 (the cyclic executive or the quantum
+// timer) installs the handler its interrupt runs.
+void hiresSetDualTimer2Handler(void (*handler)(void));
+
+#endif /* HIRES_TIMER_H */
@@ -50,12 +50,25 @@
 #include "FreeRTOS.h"
 #include "task.h"
 #include "uart.h"
+#include "resource_ceiling.h"
+#include "blocking_profiler.h"
+#include "response_time_analysis.h"
+#include "deadline_monitor.h"
+#include "execution_profile.h"
+#include "preemption_threshold.h"
+#include "cyclic_executive.h"
+#include "mixed_criticality.h"
+#include "task_chain.h"
+#include "quantum_timer.h"
+#include "tick_profile.h"
 
 /* Standard includes. */
 #include <stdio.h>
 #include <string.h>
 
-#define MAX_TICK_COUNT                     1000 // Stop scheduling after 10,000 ticks
+#ifndef MAX_TICK_COUNT
+#define MAX_TICK_COUNT                     ( 10 * configTICK_RATE_HZ ) // Stop scheduling after 10 s at any tick rate
+#endif
 
 
 /* printf() output uses the UART.  These constants define the addresses of the
@@ -68,6 +81,7 @@
 #define TX_BUFFER_MASK                        ( 1UL )
 
 extern void main_rms_deferred( void );
+extern void printAperiodicServerReport( void );
 extern int __write( int ,char *,int );
 
 /*-----------------------------------------------------------*/
@@ -96,11 +110,30 @@ void vApplicationMallocFailedHook( void )
 
 void vApplicationIdleHook( void )
 {
+    // Idle instant: a HI-mode system returns to LO mode
+    criticalityIdle();
+
     if (xTaskGetTickCount() >= MAX_TICK_COUNT)
     {
         printTaskCounts();
+        printPreemptionThresholds();
+        printMixedCriticality();
+        printTaskChains();
+        printQuantumTimer();
+        printCyclicExecutiveReport();
+        printDeadlineMisses();
+        printReleaseJitter();
+        printExecutionProfile();
         printLatencyOverhead();
+        printTickProfile();
         printAperiodicInterruptContribution();
+        printAperiodicServerReport();
+        printResourceBlocking();
+        printBlockingProfile();
+        printResponseTimeAnalysis();
+
+        // Marker for host tools capturing the UART output
+        printf("\n==== End of Report ====\n");
 
         // Disable interrupts to ensure no further tasks run
         portDISABLE_INTERRUPTS();
@@ -109,6 +142,9 @@ void vApplicationIdleHook( void )
         {
         }
     }
+
+    // Nothing to run until the next interrupt
+    idleSleep();
 }
 /*-----------------------------------------------------------*/
 
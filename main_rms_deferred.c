@@ -3,85 +3,260 @@
 #include "uart.h"
 #include "trace_task_switch.h"
 #include "tiny_print.h"
+#include "aperiodic_job.h"
+#include "edf_scheduler.h"
+#include "cbs_server.h"
+#include "resource_ceiling.h"
+#include "response_time_analysis.h"
+#include "deadline_monitor.h"
+#include "task_set.h"
+#include "hires_timer.h"
+#include "workload.h"
+#include "execution_profile.h"
+#include "aperiodic_irq.h"
+#include "aperiodic_response.h"
+#include "arrival_model.h"
+#include "slack_stealer.h"
+#include "dual_priority.h"
+#include "preemption_threshold.h"
+#include "cyclic_executive.h"
+#include "mixed_criticality.h"
+#include "task_chain.h"
+#include "quantum_timer.h"
 #include <task.h>
 
-SemaphoreHandle_t xBinarySemaphore;
-
-#define SIMPLE_LOW_DELAY                   100
-#define SIMPLE_MEDIUM_DELAY                200
-#define SIMPLE_HIGH_DELAY                  300
-#define SIMPLE_DEFERRER_SERVER_DELAY       10
-
-#define SIMPLE_LOW_COMPUTATION             2
-#define SIMPLE_MEDIUM_COMPUTATION          3
-#define SIMPLE_HIGH_COMPUTATION            5
-#define SIMPLE_APERIODIC_COMPUTATION_MIN   1 // controls the maximum of the random range of computation
-#define SIMPLE_APERIODIC_COMPUTATION_MAX   7 // controls the max of the random range of computation
-
+ResourceHandle_t xSharedResource;
+static AperiodicJobQueue aperiodicJobQueue;
+
+// Scheduling policy for the periodic tasks
+#define POLICY_RMS                         0
+#define POLICY_EDF                         1
+#define POLICY_DUAL_PRIORITY               2  // RMS with a lower band for each job until its promotion point, see dual_priority.h
+#define POLICY_CYCLIC_EXECUTIVE            3  // Static frame schedule, no tasks and no aperiodic load, see cyclic_executive.h
+
+// Server used for the aperiodic jobs
+#define SERVER_DEFERRABLE                  0
+#define SERVER_CBS                         1
+#define SERVER_SLACK_STEALING              2  // Slack stealing under POLICY_RMS, see slack_stealer.h
+
+#ifndef APERIODIC_SERVER
+#define APERIODIC_SERVER                   SERVER_DEFERRABLE
+#endif
+
+#ifndef SCHEDULING_POLICY
+#if APERIODIC_SERVER == SERVER_CBS
+#define SCHEDULING_POLICY                  POLICY_EDF
+#else
+#define SCHEDULING_POLICY                  POLICY_RMS
+#endif
+#endif
+
+// Fixed-priority order of the task set table, see task_set.h
+#ifndef PRIORITY_ASSIGNMENT
+#define PRIORITY_ASSIGNMENT                PRIORITY_RATE_MONOTONIC
+#endif
+
+// Preemption thresholds of the periodic tasks under POLICY_RMS, see preemption_threshold.h
+#ifndef PREEMPTION_THRESHOLDS
+#define PREEMPTION_THRESHOLDS              THRESHOLD_NONE
+#endif
+
+// Mixed-criticality mode switching of the periodic tasks under POLICY_RMS, see mixed_criticality.h
+#ifndef MIXED_CRITICALITY
+#define MIXED_CRITICALITY                  MC_NONE
+#endif
+// Every Nth job of each HI task runs its HI WCET, overrunning its LO budget (0 for never)
+#ifndef HI_OVERRUN_EVERY
+#define HI_OVERRUN_EVERY                   0
+#endif
+
+// Cause-effect chains among the periodic tasks, see task_chain.h
+#ifndef TASK_CHAINS
+#define TASK_CHAINS                        CHAIN_NONE
+#endif
+
+// Define as one of the WORKLOAD_* kernels to run it in every periodic task
+// instead of the workload chosen in the task set table
+// #define WORKLOAD_OVERRIDE                  WORKLOAD_CRC32
+
+// Protocol guarding the resource shared by the periodic tasks
+#ifndef RESOURCE_PROTOCOL
+#define RESOURCE_PROTOCOL                  PROTOCOL_IPCP
+#endif
+
+// Reaction of the periodic tasks to a deadline miss, see deadline_monitor.h
+#ifndef DEADLINE_MISS_POLICY
+#define DEADLINE_MISS_POLICY               MISS_POLICY_LOG
+#endif
+#define DEADLINE_WATCHDOG                  1  // Detect misses at the deadline, not only at completion
+#define DEGRADED_COMPUTATION_PERCENT       50 // Share of the computation run by a degraded job
+
+// Origin of the aperiodic events
+#define SOURCE_TASK                        0  // Producer task delaying between arrivals
+#define SOURCE_TIMER_IRQ                   1  // CMSDK TIMER0/TIMER1 interrupts, see aperiodic_irq.h
+#define SOURCE_NONE                        2  // No aperiodic events, for periodic-only comparisons
+
+#ifndef APERIODIC_SOURCE
+#define APERIODIC_SOURCE                   SOURCE_TIMER_IRQ
+#endif
+
+#if APERIODIC_SERVER == SERVER_CBS && SCHEDULING_POLICY != POLICY_EDF
+#error "The constant bandwidth server requires SCHEDULING_POLICY == POLICY_EDF"
+#endif
+#if APERIODIC_SERVER == SERVER_SLACK_STEALING && SCHEDULING_POLICY != POLICY_RMS
+#error "The slack stealing server requires SCHEDULING_POLICY == POLICY_RMS"
+#endif
+#if PREEMPTION_THRESHOLDS != THRESHOLD_NONE && (SCHEDULING_POLICY != POLICY_RMS || APERIODIC_SERVER == SERVER_SLACK_STEALING)
+#error "Preemption thresholds require SCHEDULING_POLICY == POLICY_RMS and a deferrable server"
+#endif
+#if MIXED_CRITICALITY != MC_NONE && (SCHEDULING_POLICY != POLICY_RMS || APERIODIC_SERVER != SERVER_DEFERRABLE)
+#error "Mixed criticality requires SCHEDULING_POLICY == POLICY_RMS and a deferrable server"
+#endif
+#if MIXED_CRITICALITY != MC_NONE && PREEMPTION_THRESHOLDS != THRESHOLD_NONE
+#error "The mixed-criticality analysis does not cover preemption thresholds"
+#endif
+#if TASK_CHAINS == CHAIN_ACTIVATION_TRIGGERED && (SCHEDULING_POLICY == POLICY_DUAL_PRIORITY || APERIODIC_SERVER == SERVER_SLACK_STEALING)
+#error "Activation-triggered chains need releases that dual priority and slack stealing do not assume on a fixed grid"
+#endif
+#if TIME_SLICE_QUANTUM_US > 0 && SCHEDULING_POLICY == POLICY_CYCLIC_EXECUTIVE
+#error "The quantum timer and the cyclic executive both run on DUALTIMER2"
+#endif
+#if SCHEDULING_POLICY == POLICY_DUAL_PRIORITY && APERIODIC_SERVER != SERVER_DEFERRABLE
+#error "Dual priority scheduling serves the aperiodic jobs with APERIODIC_SERVER == SERVER_DEFERRABLE"
+#endif
+#if SCHEDULING_POLICY == POLICY_DUAL_PRIORITY && RESOURCE_PROTOCOL == PROTOCOL_INHERITANCE
+#error "Dual priority scheduling needs a ceiling protocol to apply a promotion to a resource holder"
+#endif
+
+#define SIMPLE_DEFERRER_SERVER_DELAY       10 // Longest wait for an arrival before checking the replenishment
+
+// The computation range is counted in ticks of the baseline 100 Hz rate, so
+// the aperiodic load stays the same at any TICK_RATE_HZ
+#define APERIODIC_COMPUTATION_UNIT_US      10000UL
+#ifndef SIMPLE_APERIODIC_COMPUTATION_MIN
+#define SIMPLE_APERIODIC_COMPUTATION_MIN   1 // controls the minimum of the random range of computation, in 10 ms units
+#endif
+#ifndef SIMPLE_APERIODIC_COMPUTATION_MAX
+#define SIMPLE_APERIODIC_COMPUTATION_MAX   7 // controls the max of the random range of computation, in 10 ms units
+#endif
+// The same range in microseconds, for loads finer than 10 ms
+#ifndef APERIODIC_COMPUTATION_MIN_US
+#define APERIODIC_COMPUTATION_MIN_US       (SIMPLE_APERIODIC_COMPUTATION_MIN * APERIODIC_COMPUTATION_UNIT_US)
+#endif
+#ifndef APERIODIC_COMPUTATION_MAX_US
+#define APERIODIC_COMPUTATION_MAX_US       (SIMPLE_APERIODIC_COMPUTATION_MAX * APERIODIC_COMPUTATION_UNIT_US)
+#endif
+#define PERIODIC_ABORT_CHECK_US            1000 // Work done between checks for an aborted job
+
+#ifndef APERIODIC_DELAY_MIN
 #define APERIODIC_DELAY_MIN                30 // Minimum for delay range
+#endif
+#ifndef APERIODIC_DELAY_MAX
 #define APERIODIC_DELAY_MAX                100 // Maximum for delay range
-
+#endif
+#if APERIODIC_DELAY_MIN > APERIODIC_DELAY_MAX
+#error "APERIODIC_DELAY_MIN must not exceed APERIODIC_DELAY_MAX"
+#endif
+
+// Interarrival process of the aperiodic events, see arrival_model.h. All
+// models draw from a generator seeded with ARRIVAL_SEED, so every server and
+// scheduler variant sees the same arrivals for the same seed.
+#ifndef ARRIVAL_MODEL
+#define ARRIVAL_MODEL                      ARRIVAL_UNIFORM
+#endif
+#ifndef ARRIVAL_SEED
+#define ARRIVAL_SEED                       1
+#endif
+#ifndef ARRIVAL_MEAN_MS
+#define ARRIVAL_MEAN_MS                    ((APERIODIC_DELAY_MIN + APERIODIC_DELAY_MAX) / 2) // Poisson mean interarrival
+#endif
+#define ARRIVAL_CALM_MEAN_MS               120  // Bursty: mean interarrival while calm
+#define ARRIVAL_BURST_MEAN_MS              8    // Bursty: mean interarrival during a burst
+#define ARRIVAL_CALM_STAY_MS               1000 // Bursty: mean length of a calm phase
+#define ARRIVAL_BURST_STAY_MS              60   // Bursty: mean length of a burst
+
+#ifndef SERVER_BUDGET_MS
 #define SERVER_BUDGET_MS                50  // 50ms execution budget
+#endif
+#ifndef SERVER_PERIOD_MS
 #define SERVER_PERIOD_MS                100 // 100ms replenishment period
+#endif
 
+// Priority of the deferrable server under POLICY_RMS
+#define SERVER_BACKGROUND               0 // SERVER_PRIORITY, below every periodic task
+#define SERVER_RATE_MONOTONIC           1 // Its rate monotonic level among the periodic tasks, by SERVER_PERIOD_MS
 
-static TaskHandle_t xHighPriorityTask, xMediumPriorityTask, xLowPriorityTask, eventProducerHandle;
+#ifndef SERVER_PLACEMENT
+#define SERVER_PLACEMENT                SERVER_BACKGROUND
+#endif
 
-static unsigned long next = 1;
+// Under dual priority the server sits between the two bands and may run
+// whenever no job is promoted, so its budget is the whole period
+#if SCHEDULING_POLICY == POLICY_DUAL_PRIORITY
+#undef SERVER_BUDGET_MS
+#define SERVER_BUDGET_MS                SERVER_PERIOD_MS
+#endif
 
-int rand(void)
-{
-    next = next * 1103515245 + 12345;
-    return (unsigned int)(next / 65536) % 32768;
-}
+#define CBS_BUDGET_MS                   SERVER_BUDGET_MS // CBS maximum budget Qs
+#define CBS_PERIOD_MS                   SERVER_PERIOD_MS // CBS period Ts
 
-void srand(unsigned int seed)
-{
-    next = seed;
-}
 
-void runForTicks(int tickLength) {
-    TickType_t startTick, currentTick;
+#if APERIODIC_SOURCE == SOURCE_TIMER_IRQ
+extern void vApplicationSetupInterrupts(void);
+#elif APERIODIC_SOURCE == SOURCE_TASK
+static TaskHandle_t eventProducerHandle;
+#endif
+
+#if APERIODIC_SERVER == SERVER_CBS
+static CbsServerConfig cbsConfig;
+#elif APERIODIC_SERVER == SERVER_SLACK_STEALING
+static SlackServerConfig slackConfig;
+#endif
+#if APERIODIC_SOURCE == SOURCE_TIMER_IRQ
+static AperiodicIrqConfig irqConfig;
+#endif
+
+static ArrivalModelConfig arrivalConfig;
+static volatile uint32_t aperiodicJobsDropped = 0;
 
-    startTick = xTaskGetTickCount();
-    do
-    {
-        // Get the current tick count
-        currentTick = xTaskGetTickCount();
-    } while ((currentTick - startTick) < tickLength); // Run for two ticks
-}
 void deferrableServerTask(void *pvParameters)
 {
     (void)pvParameters;
     TickType_t lastWakeTime = xTaskGetTickCount();
-    TickType_t remainingBudget = pdMS_TO_TICKS(SERVER_BUDGET_MS);
+    uint32_t remainingBudgetUs = SERVER_BUDGET_MS * 1000UL;
     TickType_t serverPeriod = pdMS_TO_TICKS(SERVER_PERIOD_MS);
+    AperiodicJob *job = NULL;
+    BaseType_t jobStarted = pdFALSE;
 
     for (;;)
     {
-        // Handle queued notifications
-        while (ulTaskNotifyTake(pdTRUE, 0) > 0)
+        // Handle queued jobs while budget remains
+        while (remainingBudgetUs > 0 &&
+               (job != NULL || (job = aperiodicQueuePop(&aperiodicJobQueue)) != NULL))
         {
-            TickType_t interruptStartTime = xTaskGetTickCountFromISR();
-
-            deferredServerActive = pdTRUE; // Mark the deferred server as active
-
-            if (remainingBudget >= pdMS_TO_TICKS(SIMPLE_DEFERRER_SERVER_DELAY))
+            if (!jobStarted)
             {
-                // Process the sporadic event
-                vTaskDelay(pdMS_TO_TICKS(SIMPLE_DEFERRER_SERVER_DELAY));
-                remainingBudget -= pdMS_TO_TICKS(SIMPLE_DEFERRER_SERVER_DELAY);
+                aperiodicJobStart(job);
+                jobStarted = pdTRUE;
             }
-            else
+            deferredServerActive = pdTRUE; // Mark the deferred server as active
+
+            // Process the sporadic event against the remaining budget
+            uint32_t slice = job->computationUs < remainingBudgetUs ? job->computationUs : remainingBudgetUs;
+            burnExecutionTime(slice);
+            job->computationUs -= slice;
+            remainingBudgetUs -= slice;
+            deferredServerActive = pdFALSE; // Mark the deferred server as inactive
+
+            if (job->computationUs > 0)
             {
-                // Budget exhausted; skip event
+                // Budget exhausted; finish the job after replenishment
                 break;
             }
-            deferredServerActive = pdFALSE; // Mark the deferred server as inactive
-
-            TickType_t interruptEndTime = xTaskGetTickCountFromISR();
-            deferredServerInterruptTime += (interruptEndTime - interruptStartTime);
-            deferredServerInterruptCount++;
+            aperiodicJobComplete(job);
+            aperiodicJobFree(job);
+            job = NULL;
+            jobStarted = pdFALSE;
         }
 
         // Replenish the budget at the end of the period
@@ -89,112 +264,361 @@ void deferrableServerTask(void *pvParameters)
         {
             TickType_t elapsedPeriods = (xTaskGetTickCount() - lastWakeTime) / serverPeriod;
             lastWakeTime += elapsedPeriods * serverPeriod;
-            remainingBudget = pdMS_TO_TICKS(SERVER_BUDGET_MS);
+            remainingBudgetUs = SERVER_BUDGET_MS * 1000UL;
         }
 
-        vTaskDelay(pdMS_TO_TICKS(10)); // Avoid busy waiting
+        // Sleep until the next arrival notification, waking periodically to
+        // replenish the budget
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(SIMPLE_DEFERRER_SERVER_DELAY));
     }
 }
 
 void sporadicEventProducer(void *pvParameters)
 {
     (void)pvParameters;
+    TickType_t lastArrival = xTaskGetTickCount();
+    uint32_t arrivalRemainderUs = 0;
+
     for (;;)
     {
-        // Generate random delays and periods
-        int sporadicDelay = APERIODIC_DELAY_MIN + rand() % (APERIODIC_DELAY_MAX - APERIODIC_DELAY_MIN + 1);
-        int sporadicPeriod = SIMPLE_APERIODIC_COMPUTATION_MIN + 
-                     (rand() % (SIMPLE_APERIODIC_COMPUTATION_MAX - SIMPLE_APERIODIC_COMPUTATION_MIN + 1));
+        ArrivalEvent event = arrivalNext();
 
-        TickType_t interruptStartTime = xTaskGetTickCountFromISR();
-
-        // Simulate sporadic event
-        runForTicks(sporadicPeriod);
-        vTaskDelay(pdMS_TO_TICKS(sporadicDelay));
+        // Arrivals are absolute, so every server sees the same arrival sequence;
+        // the sub-tick part of each delay carries over to the next arrival
+        uint64_t delayUs = (uint64_t)event.delayUs + arrivalRemainderUs;
+        arrivalRemainderUs = (uint32_t)(delayUs % US_PER_TICK);
+        if (delayUs >= US_PER_TICK)
+        {
+            vTaskDelayUntil(&lastArrival, (TickType_t)(delayUs / US_PER_TICK));
+        }
 
-        // Notify the deferrable server
+        // Hand the sporadic event to the server
+        AperiodicJob *job = aperiodicJobAlloc();
+        if (job == NULL)
+        {
+            aperiodicJobsDropped++;
+            continue;
+        }
+        job->arrivalTime = xTaskGetTickCount();
+        job->computationUs = event.computationUs;
+        job->arrivalCounts = hiresNow();
+        job->source = APERIODIC_SOURCE_TASK;
+        aperiodicQueuePush(&aperiodicJobQueue, job);
         xTaskNotifyGive(serverTaskHandle);
+    }
+}
 
-        TickType_t interruptEndTime = xTaskGetTickCountFromISR();
-        deferredServerInterruptTime += (interruptEndTime - interruptStartTime);
-        deferredServerInterruptCount++;
+// Start a periodic job released at its nominal release time; under EDF its
+// absolute deadline is published from that release
+static PeriodicJob beginPeriodicJob(int taskId, TickType_t releaseTime)
+{
+    criticalityJobRelease(taskId);
+
+    PeriodicJob job = deadlineJobBegin(taskId, releaseTime);
+
+    // A skipped job never runs; the deadline monitor counts it instead
+    if (!job.skip) {
+        recordJobStart(taskId, releaseTime, xTaskGetTickCount());
     }
+#if APERIODIC_SERVER == SERVER_SLACK_STEALING
+    slackJobBegin(taskId, releaseTime);
+#endif
+#if SCHEDULING_POLICY == POLICY_EDF
+    edfSetDeadline(xTaskGetCurrentTaskHandle(), job.absoluteDeadline);
+#endif
+#if PREEMPTION_THRESHOLDS != THRESHOLD_NONE
+    thresholdJobBegin(taskId);
+#endif
+    return job;
 }
 
+static UBaseType_t periodicWorkload(const PeriodicTask *task)
+{
+#ifdef WORKLOAD_OVERRIDE
+    (void)task;
+    return WORKLOAD_OVERRIDE;
+#else
+    return task->config->workload;
+#endif
+}
 
-void lowTask(void *pvParameters)
+// Run the job's computation, or the lighter one for a degraded job, stopping
+// early if the deadline monitor or a switch to HI mode aborts it
+static void runPeriodicJob(const PeriodicJob *job, UBaseType_t workload, uint32_t computationUs)
 {
-    (void)pvParameters;
-    // Task with lower priority
-    for (;;)
-    {
-        if (xSemaphoreTake(xBinarySemaphore, portMAX_DELAY) == pdPASS)
-        {
-            runForTicks(SIMPLE_LOW_COMPUTATION);
-            xSemaphoreGive(xBinarySemaphore);
-        }
-        vTaskDelay(pdMS_TO_TICKS(SIMPLE_LOW_DELAY));
+    if (job->degraded) {
+        computationUs = (uint32_t)(((uint64_t)computationUs * DEGRADED_COMPUTATION_PERCENT + 99) / 100);
+    }
+
+    while (computationUs > 0 && !deadlineJobAborted(job) && !criticalityJobAborted(job->taskId)) {
+        uint32_t slice = computationUs < PERIODIC_ABORT_CHECK_US ? computationUs : PERIODIC_ABORT_CHECK_US;
+
+        workloadRun(workload, slice);
+        computationUs -= slice;
     }
 }
 
-void mediumTask(void *pvParameters)
+static void endPeriodicJob(const PeriodicJob *job)
 {
-    (void)pvParameters;
-    // Task with medium priority
-    for (;;)
-    {
-        if (xSemaphoreTake(xBinarySemaphore, portMAX_DELAY) == pdPASS)
-        {
-            runForTicks(SIMPLE_MEDIUM_COMPUTATION);
-            xSemaphoreGive(xBinarySemaphore);
-        }
-        vTaskDelay(pdMS_TO_TICKS(SIMPLE_MEDIUM_DELAY));
+    TickType_t completionTime = xTaskGetTickCount();
+
+#if APERIODIC_SERVER == SERVER_SLACK_STEALING
+    slackJobEnd(job->taskId);
+#endif
+    deadlineJobEnd(job, completionTime);
+    criticalityJobEnd(job->taskId);
+    if (!job->skip) {
+        recordJobCompletion(job->taskId, job->releaseTime, completionTime);
     }
+#if PREEMPTION_THRESHOLDS != THRESHOLD_NONE
+    thresholdJobEnd(job->taskId);
+#endif
 }
 
-void highTask(void *pvParameters)
+// Body shared by every entry of the task set table. A job first runs its
+// critical section holding the shared resource, then the rest of its WCET. A
+// HI job given its HI WCET reports the overrun once its WCET is spent.
+// Releases follow the fixed grid offset + k * period from the scheduler start,
+// so computation and blocking never stretch the period. A later stage of an
+// activation-triggered chain is released by its predecessor's completion
+// instead.
+static void periodicTask(void *pvParameters)
 {
-    (void)pvParameters;
-    // Task with high priority
+    const PeriodicTask *task = (const PeriodicTask *)pvParameters;
+    const UBaseType_t workload = periodicWorkload(task);
+    const BaseType_t activated = chainActivationTriggered(task->taskId);
+    TickType_t releaseTime = 0;
+
+    if (activated)
+    {
+        releaseTime = chainWaitActivation();
+    }
+    else if (task->offset > 0)
+    {
+        vTaskDelayUntil(&releaseTime, task->offset);
+    }
+
     for (;;)
     {
-        if (xSemaphoreTake(xBinarySemaphore, portMAX_DELAY) == pdPASS)
-        {           
-            runForTicks(SIMPLE_HIGH_COMPUTATION);
-            xSemaphoreGive(xBinarySemaphore);
+        PeriodicJob job = beginPeriodicJob(task->taskId, releaseTime);
+        if (!job.skip)
+        {
+            uint32_t executionStart = getTaskExecutionCounts(task->taskId);
+            uint32_t computationUs = criticalityJobComputation(task->taskId);
+
+            quantumJobBegin(task->taskId, releaseTime);
+            chainJobBegin(task->taskId);
+            if (task->criticalSectionUs > 0 && resourceTake(xSharedResource, portMAX_DELAY) == pdPASS)
+            {
+                runPeriodicJob(&job, workload, task->criticalSectionUs);
+                resourceGive(xSharedResource);
+            }
+            runPeriodicJob(&job, workload, task->computationUs - task->criticalSectionUs);
+            if (computationUs > task->computationUs && !deadlineJobAborted(&job))
+            {
+                criticalityBudgetOverrun(task->taskId);
+                runPeriodicJob(&job, workload, computationUs - task->computationUs);
+            }
+
+            executionProfileRecord(task->taskId, hiresCountsToUs(getTaskExecutionCounts(task->taskId) - executionStart));
+            chainJobEnd(task->taskId);
+            quantumJobEnd(task->taskId);
+        }
+        endPeriodicJob(&job);
+#if SCHEDULING_POLICY == POLICY_DUAL_PRIORITY
+        dualPriorityJobEnd(task->taskId, releaseTime + task->period);
+#endif
+        if (activated)
+        {
+            releaseTime = chainWaitActivation();
+            continue;
+        }
+
+        TickType_t completionTime = xTaskGetTickCount();
+        if (xTaskDelayUntil(&releaseTime, task->period) == pdFALSE && (int32_t)(completionTime - releaseTime) > 0)
+        {
+            // The next release passed while this job was running; it starts late
+            recordReleaseOverrun(task->taskId, completionTime - releaseTime);
         }
-        vTaskDelay(pdMS_TO_TICKS(SIMPLE_HIGH_DELAY));
     }
 }
 
 void main_rms_deferred(void)
 {
     initializeTaskTracking();
-    xBinarySemaphore = xSemaphoreCreateBinary();
-    xSemaphoreGive(xBinarySemaphore);
-    
-    const char taskNameLow[] = "Low";
-    const char taskNameMed[] = "Med";
-    const char taskNameHigh[] = "High";
-    const char taskAperiodic[] = "Aperiodic";
+    hiresTimerInit();
+    workloadKernelsInit();
+    taskSetLoad(PRIORITY_ASSIGNMENT);
+
+#if SCHEDULING_POLICY == POLICY_CYCLIC_EXECUTIVE
+    // The schedule table replaces the periodic tasks, the server and the
+    // aperiodic source; the kernel only runs the tick and the idle task
+    printTaskSet();
+    if (cyclicExecutiveBuild()) {
+        cyclicExecutiveStart();
+    }
+    vTaskStartScheduler();
+    return;
+#endif
+
+    arrivalConfig.model = ARRIVAL_MODEL;
+    arrivalConfig.seed = ARRIVAL_SEED;
+    arrivalConfig.delayMinUs = APERIODIC_DELAY_MIN * 1000UL;
+    arrivalConfig.delayMaxUs = APERIODIC_DELAY_MAX * 1000UL;
+    arrivalConfig.meanDelayUs = ARRIVAL_MEAN_MS * 1000UL;
+    arrivalConfig.calmMeanDelayUs = ARRIVAL_CALM_MEAN_MS * 1000UL;
+    arrivalConfig.burstMeanDelayUs = ARRIVAL_BURST_MEAN_MS * 1000UL;
+    arrivalConfig.calmMeanStayUs = ARRIVAL_CALM_STAY_MS * 1000UL;
+    arrivalConfig.burstMeanStayUs = ARRIVAL_BURST_STAY_MS * 1000UL;
+    arrivalConfig.computationMinUs = APERIODIC_COMPUTATION_MIN_US;
+    arrivalConfig.computationMaxUs = APERIODIC_COMPUTATION_MAX_US;
+    arrivalModelInit(&arrivalConfig);
+
+    // Placed before the resource ceiling is taken, since it may shift the periodic priorities
+#if APERIODIC_SERVER == SERVER_DEFERRABLE
+    UBaseType_t serverPriority = SERVER_PRIORITY;
+#if SCHEDULING_POLICY == POLICY_RMS && SERVER_PLACEMENT == SERVER_RATE_MONOTONIC
+    serverPriority = taskSetPlaceServer(pdMS_TO_TICKS(SERVER_PERIOD_MS));
+#elif SCHEDULING_POLICY == POLICY_DUAL_PRIORITY
+    serverPriority = dualPriorityLayout();
+#endif
+#endif
+    thresholdLoad(PREEMPTION_THRESHOLDS);
+    chainsLoad(TASK_CHAINS);
+
+    // The ceiling is the highest priority of the resource's users; under EDF any
+    // of them may hold the top of the dispatcher's band
+#if SCHEDULING_POLICY == POLICY_EDF
+    xSharedResource = resourceCreate("Shared", EDF_HIGHEST_PRIORITY, RESOURCE_PROTOCOL);
+#else
+    xSharedResource = resourceCreate("Shared", taskSetResourceCeiling(), RESOURCE_PROTOCOL);
+#endif
+
+    for (UBaseType_t i = 0; i < periodicTaskCount; ++i) {
+        PeriodicTask *task = &periodicTasks[i];
+        UBaseType_t priority = task->priority;
+
+#if SCHEDULING_POLICY == POLICY_DUAL_PRIORITY
+        priority = dualPriorityLow(task->taskId);
+#endif
+        if (xTaskCreate(periodicTask, task->config->name, task->config->stackDepth, task, priority, &task->handle) == pdPASS) {
+            setTaskNameFromISR(task->handle, task->config->name, task->taskId);
+        }
+    }
 
-    if (xTaskCreate(lowTask, taskNameLow, configMINIMAL_STACK_SIZE, NULL, SIMPLE_LOW_PRIORITY, &xLowPriorityTask) == pdPASS) {
-        setTaskNameFromISR(xLowPriorityTask, taskNameLow, 1);
+#if APERIODIC_SERVER == SERVER_CBS
+    cbsConfig.jobQueue = &aperiodicJobQueue;
+    cbsConfig.budget = pdMS_TO_TICKS(CBS_BUDGET_MS);
+    cbsConfig.period = pdMS_TO_TICKS(CBS_PERIOD_MS);
+    if (xTaskCreate(cbsServerTask, "CBS", configMINIMAL_STACK_SIZE, &cbsConfig, SERVER_PRIORITY, &serverTaskHandle) == pdPASS) {
+        setTaskNameFromISR(serverTaskHandle, "CBS", SERVER_TASK_ID);
     }
-    if (xTaskCreate(mediumTask, taskNameMed, configMINIMAL_STACK_SIZE*2, NULL, SIMPLE_MEDIUM_PRIROITY, &xMediumPriorityTask) == pdPASS) {
-        setTaskNameFromISR(xMediumPriorityTask, taskNameMed, 2);
+#elif APERIODIC_SERVER == SERVER_SLACK_STEALING
+    slackStealerInit();
+    slackConfig.jobQueue = &aperiodicJobQueue;
+    slackConfig.topPriority = SLACK_SERVER_PRIORITY;
+    slackConfig.backgroundPriority = SERVER_PRIORITY;
+    if (xTaskCreate(slackServerTask, "SlackStealer", configMINIMAL_STACK_SIZE, &slackConfig, SLACK_SERVER_PRIORITY, &serverTaskHandle) == pdPASS) {
+        setTaskNameFromISR(serverTaskHandle, "SlackStealer", SERVER_TASK_ID);
     }
-    if (xTaskCreate(highTask, taskNameHigh, configMINIMAL_STACK_SIZE*4, NULL, SIMPLE_HIGH_PRIORITY, &xHighPriorityTask) == pdPASS) {
-        setTaskNameFromISR(xHighPriorityTask, taskNameHigh, 3);
+#else
+    if (xTaskCreate(deferrableServerTask, "DeferrableServer", configMINIMAL_STACK_SIZE, NULL, serverPriority, &serverTaskHandle) == pdPASS) {
+        setTaskNameFromISR(serverTaskHandle, "DeferrableServer", SERVER_TASK_ID);
     }
-
-    xTaskCreate(deferrableServerTask, "DeferrableServer", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY+2, &serverTaskHandle);
-    if (xTaskCreate(sporadicEventProducer, taskAperiodic, configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY+1, &eventProducerHandle) == pdPASS) {
-        setTaskNameFromISR(eventProducerHandle, taskAperiodic, 4);
+#endif
+#if APERIODIC_SOURCE == SOURCE_TIMER_IRQ
+    irqConfig.jobQueue = &aperiodicJobQueue;
+    irqConfig.server = serverTaskHandle;
+    vApplicationSetupInterrupts();
+    aperiodicIrqStart(&irqConfig);
+#elif APERIODIC_SOURCE == SOURCE_TASK
+    if (xTaskCreate(sporadicEventProducer, "Aperiodic", configMINIMAL_STACK_SIZE, NULL, SIMPLE_APERIODIC_PRIORTY, &eventProducerHandle) == pdPASS) {
+        setTaskNameFromISR(eventProducerHandle, "Aperiodic", APERIODIC_TASK_ID);
     }
+#endif
+
+    for (UBaseType_t i = 0; i < periodicTaskCount; ++i) {
+        PeriodicTask *task = &periodicTasks[i];
+
+#if SCHEDULING_POLICY == POLICY_EDF
+        edfRegisterTask(task->handle, task->offset + task->deadline);
+#endif
+        deadlineMonitorRegister(task->taskId, task->deadline, DEADLINE_MISS_POLICY, DEADLINE_WATCHDOG);
+        executionProfileRegister(task->taskId, task->computationUs, periodicWorkload(task));
+
+        // Worst-case response times predicted from the task set table
+        rtaAddTask(task->config->name, task->taskId, task->computation, task->period,
+                   task->deadline, task->priority, task->criticalSection);
+#if PREEMPTION_THRESHOLDS != THRESHOLD_NONE
+        rtaSetThreshold(task->taskId, thresholdGet(task->taskId));
+#endif
+#if MIXED_CRITICALITY == MC_DROP
+        rtaSetCriticality(task->taskId, task->config->criticality == CRITICALITY_HI,
+                          task->config->criticality == CRITICALITY_HI ? task->computationHi : 0);
+#elif MIXED_CRITICALITY == MC_DEGRADE
+        rtaSetCriticality(task->taskId, task->config->criticality == CRITICALITY_HI,
+                          task->config->criticality == CRITICALITY_HI ? task->computationHi :
+                          TASK_US_TO_TICKS(((uint64_t)task->computationUs * DEGRADED_COMPUTATION_PERCENT + 99) / 100));
+#endif
+    }
+    criticalityInit(MIXED_CRITICALITY, HI_OVERRUN_EVERY, serverTaskHandle, SERVER_PRIORITY);
+#if APERIODIC_SERVER == SERVER_CBS
+    edfRegisterTask(serverTaskHandle, pdMS_TO_TICKS(CBS_PERIOD_MS));
+#endif
+
+#if APERIODIC_SERVER == SERVER_CBS
+    rtaAddTask("CBS", -1, pdMS_TO_TICKS(CBS_BUDGET_MS), pdMS_TO_TICKS(CBS_PERIOD_MS),
+               pdMS_TO_TICKS(CBS_PERIOD_MS), SERVER_PRIORITY, 0);
+#elif APERIODIC_SERVER == SERVER_SLACK_STEALING
+    // The slack stealer only spends slack, so it adds no interference to the analysis
+#elif SCHEDULING_POLICY == POLICY_DUAL_PRIORITY
+    // The server runs below every promoted job, so it adds no interference to the analysis
+#else
+    rtaAddDeferrableServer("DeferrableServer", pdMS_TO_TICKS(SERVER_BUDGET_MS), pdMS_TO_TICKS(SERVER_PERIOD_MS),
+                           serverPriority);
+#endif
+    printTaskSet();
+    rtaAnalyze(SCHEDULING_POLICY != POLICY_EDF);
+
+#if SCHEDULING_POLICY == POLICY_DUAL_PRIORITY
+    // Promotion points from the response times in the upper band
+    for (UBaseType_t i = 0; i < periodicTaskCount; ++i) {
+        const PeriodicTask *task = &periodicTasks[i];
+        const RtaTask *rta = rtaFindTask(task->taskId);
+
+        dualPriorityStart(task->taskId, task->handle, rta->schedulable ? rta->response : task->deadline,
+                          task->deadline, task->offset);
+    }
+#endif
 
     xTaskCreate(vLogContextSwitchTask, "RMS Log Switch Task", configMINIMAL_STACK_SIZE * 2, NULL, tskIDLE_PRIORITY, NULL);
 
+    quantumTimerStart();
     vTaskStartScheduler();
+}
 
+// Report for the aperiodic server selected at build time
+void printAperiodicServerReport(void)
+{
+#if APERIODIC_SERVER == SERVER_CBS
+    printf("\n==== Aperiodic Server: CBS (EDF) ====\n");
+#elif APERIODIC_SERVER == SERVER_SLACK_STEALING
+    printf("\n==== Aperiodic Server: Slack Stealing (RMS) ====\n");
+#elif SCHEDULING_POLICY == POLICY_DUAL_PRIORITY
+    printf("\n==== Aperiodic Server: Deferrable (Dual Priority) ====\n");
+#else
+    printf("\n==== Aperiodic Server: Deferrable (%s) ====\n", SCHEDULING_POLICY == POLICY_EDF ? "EDF" : "RMS");
+#endif
+    printf("Arrival Model: %s, seed %lu\n", arrivalModelName(), (uint32_t)ARRIVAL_SEED);
+    printf("Aperiodic Jobs Dropped: %lu\n", aperiodicJobsDropped);
+    printf("Aperiodic Jobs Outstanding: %lu\n", aperiodicJobsInUse());
+#if APERIODIC_SERVER == SERVER_CBS
+    printCbsServerStats();
+#elif APERIODIC_SERVER == SERVER_SLACK_STEALING
+    printSlackStealerStats();
+#elif SCHEDULING_POLICY == POLICY_DUAL_PRIORITY
+    printDualPriorityReport();
+#endif
+    printAperiodicResponseTimes();
+    printAperiodicIrqLatency();
 }
@@ -0,0 +1,227 @@
+#include "mixed_criticality.h"
+#include "task_set.h"
+#include "deadline_monitor.h"
+#include "hires_timer.h"
+#include "tiny_print.h"
+
+// Criticality bookkeeping for one periodic task
+typedef struct {
+    BaseType_t registered;
+    BaseType_t hiCriticality;
+    uint32_t computationUs;       // C(LO), the table WCET
+    uint32_t computationHiUs;     // C(HI)
+    uint32_t jobComputationUs;    // What the current job executes
+    BaseType_t aborting;          // The current LO job was stopped by HI mode
+
+    // Counters for the final report
+    uint32_t jobs;
+    uint32_t overruns;
+    uint32_t dropped;
+    uint32_t aborted;
+    uint32_t degraded;
+} CriticalityTask;
+
+static CriticalityTask criticalityTasks[MAX_TASKS];
+static UBaseType_t criticalityPolicy = MC_NONE;
+static uint32_t hiOverrunEvery = 0;
+static TaskHandle_t serverHandle = NULL;
+static UBaseType_t serverPriority = 0;
+static UBaseType_t serverBackgroundPriority = 0;
+
+static volatile BaseType_t hiMode = pdFALSE;
+static TickType_t hiModeEntered = 0;
+static TickType_t hiModeTicks = 0;
+static uint32_t modeSwitches = 0;
+static uint32_t modeReturns = 0;
+static uint32_t switchLatencyTotal = 0;  // High resolution counts from the overrun to the switch in effect
+static uint32_t switchLatencyMax = 0;
+
+static const char *policyName(UBaseType_t policy)
+{
+    switch (policy) {
+        case MC_DROP:    return "Drop";
+        case MC_DEGRADE: return "Degrade";
+        default:         return "None";
+    }
+}
+
+// Take the criticality and both budgets of every periodic task from the task
+// set table. Every overrunEvery-th job of a HI task runs its C(HI) (never if
+// 0). The server is suspended (MC_DROP) or lowered to backgroundPriority
+// (MC_DEGRADE) in HI mode. Call once the tasks and the server exist.
+void criticalityInit(UBaseType_t policy, uint32_t overrunEvery, TaskHandle_t server, UBaseType_t backgroundPriority)
+{
+    criticalityPolicy = policy;
+    hiOverrunEvery = overrunEvery;
+    serverHandle = server;
+    serverPriority = server != NULL ? uxTaskPriorityGet(server) : 0;
+    serverBackgroundPriority = backgroundPriority;
+
+    for (UBaseType_t i = 0; i < periodicTaskCount; ++i) {
+        const PeriodicTask *task = &periodicTasks[i];
+        CriticalityTask *entry = &criticalityTasks[task->taskId];
+
+        entry->registered = pdTRUE;
+        entry->hiCriticality = task->config->criticality == CRITICALITY_HI;
+        entry->computationUs = task->computationUs;
+        entry->computationHiUs = task->computationHiUs;
+        entry->jobComputationUs = task->computationUs;
+    }
+}
+
+// Called at each release, before the deadline monitor opens the job. In HI
+// mode a LO job is dropped or degraded; a HI job runs its C(HI) on every
+// overrunEvery-th release.
+void criticalityJobRelease(int taskId)
+{
+    CriticalityTask *task = &criticalityTasks[taskId];
+
+    task->jobs++;
+    task->jobComputationUs = task->computationUs;
+
+    if (task->hiCriticality) {
+        if (hiOverrunEvery > 0 && task->jobs % hiOverrunEvery == 0) {
+            task->jobComputationUs = task->computationHiUs;
+        }
+    } else if (hiMode && criticalityPolicy != MC_NONE) {
+        deadlineSetNextJob(taskId, criticalityPolicy == MC_DROP, criticalityPolicy == MC_DEGRADE);
+        if (criticalityPolicy == MC_DROP) {
+            task->dropped++;
+        } else {
+            task->degraded++;
+        }
+    }
+}
+
+uint32_t criticalityJobComputation(int taskId)
+{
+    return criticalityTasks[taskId].jobComputationUs;
+}
+
+// Called by a job that has spent its C(LO) with work left. A HI job switches
+// the system to HI mode; the latency runs from here until the LO tasks and
+// the server are held back.
+void criticalityBudgetOverrun(int taskId)
+{
+    CriticalityTask *task = &criticalityTasks[taskId];
+    uint32_t overrunCounts = hiresNow();
+
+    task->overruns++;
+    if (criticalityPolicy == MC_NONE || !task->hiCriticality || hiMode) {
+        return;
+    }
+
+    hiMode = pdTRUE;
+    hiModeEntered = xTaskGetTickCount();
+    if (serverHandle != NULL) {
+        if (criticalityPolicy == MC_DROP) {
+            vTaskSuspend(serverHandle);
+        } else if (serverPriority > serverBackgroundPriority) {
+            vTaskPrioritySet(serverHandle, serverBackgroundPriority);
+        }
+    }
+
+    uint32_t latency = hiresNow() - overrunCounts;
+    switchLatencyTotal += latency;
+    if (latency > switchLatencyMax) {
+        switchLatencyMax = latency;
+    }
+    modeSwitches++;
+}
+
+// Polled by the job body between units of work: under MC_DROP a LO job still
+// running in HI mode stops, releasing the resource at its next check
+BaseType_t criticalityJobAborted(int taskId)
+{
+    CriticalityTask *task = &criticalityTasks[taskId];
+
+    if (hiMode && criticalityPolicy == MC_DROP && task->registered && !task->hiCriticality) {
+        task->aborting = pdTRUE;
+    }
+    return task->aborting;
+}
+
+void criticalityJobEnd(int taskId)
+{
+    CriticalityTask *task = &criticalityTasks[taskId];
+
+    if (task->aborting) {
+        task->aborted++;
+        task->aborting = pdFALSE;
+    }
+}
+
+// Called from the idle hook. The idle task only runs when no periodic job is
+// pending, so this is an idle instant and the system returns to LO mode. The
+// scheduler is suspended so that no overrun interleaves with the return.
+void criticalityIdle(void)
+{
+    if (!hiMode) {
+        return;
+    }
+
+    vTaskSuspendAll();
+    {
+        hiMode = pdFALSE;
+        hiModeTicks += xTaskGetTickCount() - hiModeEntered;
+        if (serverHandle != NULL) {
+            if (criticalityPolicy == MC_DROP) {
+                vTaskResume(serverHandle);
+            } else {
+                vTaskPrioritySet(serverHandle, serverPriority);
+            }
+        }
+        modeReturns++;
+    }
+    xTaskResumeAll();
+}
+
+void printMixedCriticality(void)
+{
+    uint32_t sacrificed = 0;
+    uint32_t overruns = 0;
+    BaseType_t any = pdFALSE;
+
+    for (UBaseType_t i = 0; i < MAX_TASKS; ++i) {
+        const CriticalityTask *task = &criticalityTasks[i];
+
+        if (task->registered) {
+            any = pdTRUE;
+        }
+        sacrificed += task->dropped + task->aborted + task->degraded;
+        overruns += task->overruns;
+    }
+    if (!any) {
+        return;
+    }
+
+    printf("\n==== Mixed Criticality ====\n");
+    printf("Policy: %s\n", policyName(criticalityPolicy));
+    printf("HI Overrun Every: %lu\n", hiOverrunEvery);
+    printf("Budget Overruns: %lu\n", overruns);
+    printf("Mode Switches: %lu\n", modeSwitches);
+    printf("Returns to LO: %lu\n", modeReturns);
+    printf("Time in HI Mode (ticks): %lu\n", hiModeTicks + (hiMode ? xTaskGetTickCount() - hiModeEntered : 0));
+    printf("Mean Switch Latency (ns): %lu\n", hiresCountsToNs(modeSwitches ? switchLatencyTotal / modeSwitches : 0));
+    printf("Max Switch Latency (ns): %lu\n", hiresCountsToNs(switchLatencyMax));
+    printf("LO Jobs Sacrificed: %lu\n", sacrificed);
+    printf("Task,Criticality,C(LO) (us),C(HI) (us),Jobs,Overruns,Dropped,Aborted,Degraded\n");
+
+    for (UBaseType_t i = 0; i < MAX_TASKS; ++i) {
+        const CriticalityTask *task = &criticalityTasks[i];
+
+        if (!task->registered) {
+            continue;
+        }
+        printf("\"%s\",%s,%lu,%lu,%lu,%lu,%lu,%lu,%lu\n",
+               taskInfo[i].taskName,
+               task->hiCriticality ? "HI" : "LO",
+               task->computationUs,
+               task->computationHiUs,
+               task->jobs,
+               task->overruns,
+               task->dropped,
+               task->aborted,
+               task->degraded);
+    }
+}
@@ -0,0 +1,27 @@
+#ifndef MIXED_CRITICALITY_H
+#define MIXED_CRITICALITY_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "trace_task_switch.h"
+
+// Adaptive mixed criticality (AMC, Baruah, Burns and Davis) for the periodic
+// tasks. The system starts in LO mode, where every job's budget is its table
+// WCET, C(LO). A HI task whose job still has work left when that budget is
+// spent switches the system to HI mode: LO jobs released from then on are
+// dropped or degraded, and the aperiodic server is suspended or moved to the
+// background. The first idle instant returns the system to LO mode.
+#define MC_NONE                            0  // Overruns are counted, the mode never changes
+#define MC_DROP                            1  // HI mode drops LO jobs, aborts those in progress and suspends the server
+#define MC_DEGRADE                         2  // HI mode runs LO jobs degraded and the server in the background
+
+void criticalityInit(UBaseType_t policy, uint32_t overrunEvery, TaskHandle_t server, UBaseType_t backgroundPriority);
+void criticalityJobRelease(int taskId);
+uint32_t criticalityJobComputation(int taskId);
+void criticalityBudgetOverrun(int taskId);
+BaseType_t criticalityJobAborted(int taskId);
+void criticalityJobEnd(int taskId);
+void criticalityIdle(void);
+void printMixedCriticality(void);
+
+#endif /* MIXED_CRITICALITY_H */
@@ -0,0 +1,131 @@
+#include "preemption_threshold.h"
+#include "task_set.h"
+#include "tiny_print.h"
+#include <string.h>
+
+// One row of THRESHOLD_FILE: the task and the task whose priority is its threshold
+typedef struct {
+    const char *task;
+    const char *thresholdTask;
+} ThresholdEntry;
+
+// Each line of THRESHOLD_FILE is one TASK_THRESHOLD(...) row
+static const ThresholdEntry thresholdTable[] = {
+#define TASK_THRESHOLD(task, thresholdTask) { task, thresholdTask },
+#include THRESHOLD_FILE
+#undef TASK_THRESHOLD
+};
+
+#define THRESHOLD_TABLE_SIZE ( sizeof(thresholdTable) / sizeof(thresholdTable[0]) )
+
+static UBaseType_t thresholdMode = THRESHOLD_NONE;
+static UBaseType_t basePriorities[MAX_TASKS];
+static UBaseType_t thresholds[MAX_TASKS];
+
+// Preemptions of the periodic jobs: switch-outs between thresholdJobBegin()
+// and thresholdJobEnd() that left the task ready
+static volatile BaseType_t jobActive[MAX_TASKS];
+static volatile uint32_t preemptions[MAX_TASKS];
+
+static const PeriodicTask *findPeriodicTask(const char *name)
+{
+    for (UBaseType_t i = 0; i < periodicTaskCount; ++i) {
+        if (strcmp(periodicTasks[i].config->name, name) == 0) {
+            return &periodicTasks[i];
+        }
+    }
+    return NULL;
+}
+
+// Resolve the thresholds against the final priorities of the periodic tasks.
+// A threshold below the task's own priority is raised to it. Call after
+// taskSetLoad() and any server placement, before the tasks are created.
+void thresholdLoad(UBaseType_t mode)
+{
+    UBaseType_t top = 0;
+
+    thresholdMode = mode;
+    for (UBaseType_t i = 0; i < periodicTaskCount; ++i) {
+        const PeriodicTask *task = &periodicTasks[i];
+
+        basePriorities[task->taskId] = task->priority;
+        thresholds[task->taskId] = task->priority;
+        if (task->priority > top) {
+            top = task->priority;
+        }
+    }
+
+    if (mode == THRESHOLD_NON_PREEMPTIVE) {
+        for (UBaseType_t i = 0; i < periodicTaskCount; ++i) {
+            thresholds[periodicTasks[i].taskId] = top;
+        }
+    } else if (mode == THRESHOLD_TABLE) {
+        for (UBaseType_t i = 0; i < THRESHOLD_TABLE_SIZE; ++i) {
+            const ThresholdEntry *entry = &thresholdTable[i];
+            const PeriodicTask *task = findPeriodicTask(entry->task);
+            const PeriodicTask *reference = findPeriodicTask(entry->thresholdTask);
+
+            if (task == NULL || reference == NULL) {
+                printf("Threshold entry rejected: Task='%s', Threshold='%s'\n", entry->task, entry->thresholdTask);
+                configASSERT(0);
+                continue;
+            }
+            if (reference->priority > task->priority) {
+                thresholds[task->taskId] = reference->priority;
+            }
+        }
+    }
+}
+
+UBaseType_t thresholdGet(int taskId)
+{
+    return thresholds[taskId];
+}
+
+// Called by a dispatched job before its computation: from here until it
+// blocks, tasks at or below the threshold cannot preempt it
+void thresholdJobBegin(int taskId)
+{
+    jobActive[taskId] = pdTRUE;
+    if (thresholds[taskId] > basePriorities[taskId]) {
+        vTaskPrioritySet(NULL, thresholds[taskId]);
+    }
+}
+
+// Called when the job ends, before the task blocks until its next release.
+// Dropping to the base priority yields to any task released between the two
+// levels; that switch comes after the job and is not a preemption.
+void thresholdJobEnd(int taskId)
+{
+    jobActive[taskId] = pdFALSE;
+    if (thresholds[taskId] > basePriorities[taskId]) {
+        vTaskPrioritySet(NULL, basePriorities[taskId]);
+    }
+}
+
+// Called from the switch-out trace hook
+void thresholdSwitchedOut(UBaseType_t taskIndex, BaseType_t stillReady)
+{
+    if (taskIndex < MAX_TASKS && jobActive[taskIndex] && stillReady) {
+        preemptions[taskIndex]++;
+    }
+}
+
+// Switches count every switch-out of the task, including blocking on the
+// resource and the yield after a job; Preemptions only those of a running job
+// that left it ready
+void printPreemptionThresholds(void)
+{
+    static const char *const modeNames[] = { "none", "table", "non-preemptive" };
+
+    printf("\n==== Preemption Thresholds (%s) ====\n", modeNames[thresholdMode]);
+    printf("Task,Priority,Threshold,Jobs,Switches,Preemptions\n");
+
+    for (UBaseType_t i = 0; i < periodicTaskCount; ++i) {
+        const PeriodicTask *task = &periodicTasks[i];
+        const TaskInfo *info = &taskInfo[task->taskId];
+
+        printf("\"%s\",%lu,%lu,%lu,%lu,%lu\n", task->config->name, basePriorities[task->taskId],
+               thresholds[task->taskId], info->jobCount, info->switchCount, preemptions[task->taskId]);
+    }
+}
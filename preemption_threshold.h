@@ -0,0 +1,29 @@
+#ifndef PREEMPTION_THRESHOLD_H
+#define PREEMPTION_THRESHOLD_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "trace_task_switch.h"
+
+// Preemption thresholds for the fixed-priority periodic tasks. A task is
+// released at its priority, but once a job is dispatched it runs at its
+// threshold until it blocks, so only tasks above the threshold can preempt it.
+// The thresholds are given by name in THRESHOLD_FILE, see
+// tools/threshold_assign.py; override with -DTHRESHOLD_FILE=\"thresholds/<name>.h\"
+#ifndef THRESHOLD_FILE
+#define THRESHOLD_FILE "thresholds/default.h"
+#endif
+
+// Source of the thresholds
+#define THRESHOLD_NONE                     0  // Threshold = priority, fully preemptive
+#define THRESHOLD_TABLE                    1  // From THRESHOLD_FILE
+#define THRESHOLD_NON_PREEMPTIVE           2  // The top periodic priority, no periodic task preempts another
+
+void thresholdLoad(UBaseType_t mode);
+UBaseType_t thresholdGet(int taskId);
+void thresholdJobBegin(int taskId);
+void thresholdJobEnd(int taskId);
+void thresholdSwitchedOut(UBaseType_t taskIndex, BaseType_t stillReady);
+void printPreemptionThresholds(void);
+
+#endif /* PREEMPTION_THRESHOLD_H */
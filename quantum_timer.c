@@ -0,0 +1,160 @@
+#include "quantum_timer.h"
+#include "hires_timer.h"
+#include "workload.h"
+#include "tiny_print.h"
+#include "CMSDK_CM3.h"
+
+#if TIME_SLICE_QUANTUM_US > 0 && TIME_SLICE_QUANTUM_US < QUANTUM_MIN_US
+#error "TIME_SLICE_QUANTUM_US must be 0 (slice on the tick) or at least QUANTUM_MIN_US"
+#endif
+
+static BaseType_t quantumRunning = pdFALSE;
+static uint32_t quantumCounts = 0;
+
+// An expiry is resolved at the next switch-in: another task of the expired
+// task's priority is a rotation, the expired task itself a renewal. A switch
+// to a task of another priority is neither.
+static volatile TaskHandle_t expiredTask = NULL;
+static volatile UBaseType_t expiredPriority = 0;
+static volatile uint32_t quantumExpiries = 0;
+static volatile uint32_t quantumRotations = 0;
+static volatile uint32_t quantumRenewals = 0;
+static uint32_t expiryLatencyTotal = 0;  // High resolution counts from the expiry to the handler entry
+static uint32_t expiryLatencyMax = 0;
+
+// Release-to-completion time of the periodic jobs in high resolution counts.
+// A job is measured from the instant the kernel readied its task, which the
+// tick-based response times of the other sections cannot resolve.
+static uint32_t jobReleaseCounts[MAX_TASKS];
+static BaseType_t jobMeasured[MAX_TASKS];
+static uint32_t responseJobs[MAX_TASKS];
+static uint64_t responseTotal[MAX_TASKS];
+static uint32_t responseMax[MAX_TASKS];
+
+// Quantum expiry: pend PendSV so the kernel picks the next task of the
+// running task's priority. Only the first expiry before the switch is kept.
+static void quantumExpired(void)
+{
+    uint32_t sinceExpiry = CMSDK_DUALTIMER2->TimerLoad - CMSDK_DUALTIMER2->TimerValue;
+
+    CMSDK_DUALTIMER2->TimerIntClr = CMSDK_DUALTIMER2_INTCLR_Msk;
+    quantumExpiries++;
+    expiryLatencyTotal += sinceExpiry;
+    if (sinceExpiry > expiryLatencyMax) {
+        expiryLatencyMax = sinceExpiry;
+    }
+
+    if (expiredTask == NULL) {
+        expiredTask = xTaskGetCurrentTaskHandle();
+        expiredPriority = uxTaskPriorityGetFromISR(expiredTask);
+    }
+    portYIELD_FROM_ISR(pdTRUE);
+}
+
+// Start DUALTIMER2 in periodic mode at the quantum. Its interrupt sits one
+// level above SysTick and PendSV, which share the lowest level, so it can
+// preempt the tick; the handler only pends PendSV. It stays masked until the
+// scheduler starts. Does nothing when the tick slices.
+void quantumTimerStart(void)
+{
+#if TIME_SLICE_QUANTUM_US > 0
+    quantumCounts = hiresUsToCounts(TIME_SLICE_QUANTUM_US);
+    CMSDK_DUALTIMER2->TimerControl = 0;
+    CMSDK_DUALTIMER2->TimerIntClr = CMSDK_DUALTIMER2_INTCLR_Msk;
+    CMSDK_DUALTIMER2->TimerLoad = quantumCounts - 1;
+    hiresSetDualTimer2Handler(quantumExpired);
+    quantumRunning = pdTRUE;
+    CMSDK_DUALTIMER2->TimerControl = CMSDK_DUALTIMER2_CTRL_EN_Msk | CMSDK_DUALTIMER2_CTRL_MODE_Msk |
+                                     CMSDK_DUALTIMER2_CTRL_INTEN_Msk | CMSDK_DUALTIMER2_CTRL_SIZE_Msk;
+
+    NVIC_SetPriority(DUALTIMER_IRQn, configLIBRARY_LOWEST_INTERRUPT_PRIORITY - 1);
+    NVIC_EnableIRQ(DUALTIMER_IRQn);
+#endif
+}
+
+// Called from the switch-in trace hook: the task switched in gets a whole
+// quantum. Writing the load register restarts the count; an expiry of the
+// previous quantum still pending is dropped.
+void quantumSwitchedIn(void)
+{
+    if (!quantumRunning) {
+        return;
+    }
+
+    CMSDK_DUALTIMER2->TimerLoad = quantumCounts - 1;
+    CMSDK_DUALTIMER2->TimerIntClr = CMSDK_DUALTIMER2_INTCLR_Msk;
+    NVIC_ClearPendingIRQ(DUALTIMER_IRQn);
+
+    if (expiredTask != NULL) {
+        TaskHandle_t current = xTaskGetCurrentTaskHandle();
+
+        if (current == expiredTask) {
+            quantumRenewals++;
+        } else if (uxTaskPriorityGetFromISR(current) == expiredPriority) {
+            quantumRotations++;
+        }
+        expiredTask = NULL;
+    }
+}
+
+// Called when a periodic job starts. The job is measured only if the kernel
+// readied its task at the release tick; a job released late, after an
+// overrun of the previous one, never waited in the ready list.
+void quantumJobBegin(int taskId, TickType_t releaseTime)
+{
+    if (taskId < 0 || taskId >= MAX_TASKS) {
+        return;
+    }
+    jobMeasured[taskId] = taskInfo[taskId].readyTime == releaseTime && taskInfo[taskId].readyCounts != 0;
+    jobReleaseCounts[taskId] = taskInfo[taskId].readyCounts;
+}
+
+void quantumJobEnd(int taskId)
+{
+    if (taskId < 0 || taskId >= MAX_TASKS || !jobMeasured[taskId]) {
+        return;
+    }
+
+    uint32_t response = hiresNow() - jobReleaseCounts[taskId];
+
+    responseJobs[taskId]++;
+    responseTotal[taskId] += response;
+    if (response > responseMax[taskId]) {
+        responseMax[taskId] = response;
+    }
+}
+
+// Stops the quantum timer, then reports. Expiries that were neither a
+// rotation nor a renewal were overtaken by a switch to another priority.
+void printQuantumTimer(void)
+{
+    if (quantumRunning) {
+        quantumRunning = pdFALSE;
+        CMSDK_DUALTIMER2->TimerControl = 0;
+    }
+
+    printf("\n==== Round-Robin Quantum ====\n");
+    printf("Quantum Source: %s\n", TIME_SLICE_QUANTUM_US > 0 ? "DUALTIMER2" : configUSE_TIME_SLICING ? "tick" : "none");
+    printf("Quantum (us): %lu\n", TIME_SLICE_QUANTUM_US > 0 ? (uint32_t)TIME_SLICE_QUANTUM_US : US_PER_TICK);
+    if (TIME_SLICE_QUANTUM_US > 0) {
+        uint32_t expiries = quantumExpiries ? quantumExpiries : 1;
+
+        printf("Expiries: %lu\n", quantumExpiries);
+        printf("Rotations: %lu\n", quantumRotations);
+        printf("Renewals: %lu\n", quantumRenewals);
+        printf("Mean Expiry Latency (ns): %lu\n", hiresCountsToNs(expiryLatencyTotal / expiries));
+        printf("Max Expiry Latency (ns): %lu\n", hiresCountsToNs(expiryLatencyMax));
+    }
+
+    printf("Task,Measured Jobs,Mean Response (us),Max Response (us)\n");
+    for (UBaseType_t i = 0; i < MAX_TASKS; ++i) {
+        if (responseJobs[i] == 0) {
+            continue;
+        }
+        printf("\"%s\",%lu,%lu,%lu\n",
+               taskInfo[i].taskName,
+               responseJobs[i],
+               hiresCountsToUs((uint32_t)(responseTotal[i] / responseJobs[i])),
+               hiresCountsToUs(responseMax[i]));
+    }
+}
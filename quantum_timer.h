@@ -0,0 +1,22 @@
+#ifndef QUANTUM_TIMER_H
+#define QUANTUM_TIMER_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "trace_task_switch.h"
+
+// Round-robin quantum of the tasks of equal priority, independent of the tick.
+// With TIME_SLICE_QUANTUM_US (FreeRTOSConfig.h) above 0 the tick no longer
+// slices. CMSDK DUALTIMER2 is restarted at every switch-in instead, and once
+// the running task has held the CPU for a whole quantum its interrupt pends
+// PendSV. The kernel then switches to the next ready task of the same
+// priority, or back to the same task if it is alone at its priority.
+#define QUANTUM_MIN_US               100  // Shorter quanta leave the tasks little but the switch
+
+void quantumTimerStart(void);
+void quantumSwitchedIn(void);
+void quantumJobBegin(int taskId, TickType_t releaseTime);
+void quantumJobEnd(int taskId);
+void printQuantumTimer(void);
+
+#endif /* QUANTUM_TIMER_H */
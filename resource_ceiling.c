@@ -0,0 +1,188 @@
+#include "resource_ceiling.h"
+#include "edf_scheduler.h"
+#include "dual_priority.h"
+#include "blocking_profiler.h"
+#include "hires_timer.h"
+#include "tiny_print.h"
+#include <string.h>
+#include <task.h>
+
+static Resource resources[MAX_RESOURCES];
+static UBaseType_t resourceCount = 0;
+
+static const char *protocolName(UBaseType_t protocol)
+{
+    switch (protocol) {
+        case PROTOCOL_INHERITANCE: return "Inheritance";
+        case PROTOCOL_IPCP:        return "IPCP";
+        default:                   return "None";
+    }
+}
+
+// Create a resource and declare its priority ceiling
+ResourceHandle_t resourceCreate(const char *name, UBaseType_t ceiling, UBaseType_t protocol)
+{
+    if (resourceCount >= MAX_RESOURCES || ceiling >= configMAX_PRIORITIES) {
+        printf("Resource creation failed: Name='%s', Ceiling=%lu\n", name ? name : "(null)", ceiling);
+        configASSERT(0);
+        return NULL;
+    }
+
+    Resource *resource = &resources[resourceCount++];
+    memset(resource, 0, sizeof(Resource));
+    resource->name = name;
+    resource->protocol = protocol;
+    resource->ceiling = ceiling;
+
+    if (protocol == PROTOCOL_INHERITANCE) {
+        resource->semaphore = xSemaphoreCreateMutex();
+    } else {
+        resource->semaphore = xSemaphoreCreateBinary();
+        xSemaphoreGive(resource->semaphore);
+    }
+    configASSERT(resource->semaphore != NULL);
+
+    return resource;
+}
+
+BaseType_t resourceTake(ResourceHandle_t resource, TickType_t timeout)
+{
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    UBaseType_t taskIndex = findTaskIndex(self);
+    UBaseType_t basePriority = uxTaskPriorityGet(NULL);
+    TickType_t requestTime = xTaskGetTickCount();
+
+    profilerOnRequest(resource, basePriority, requestTime, hiresNow());
+
+    // IPCP: run at the ceiling for the whole critical section so no other user
+    // of the resource can preempt the holder
+    if (resource->protocol == PROTOCOL_IPCP && resource->ceiling > basePriority) {
+        vTaskPrioritySet(NULL, resource->ceiling);
+    }
+
+    if (xSemaphoreTake(resource->semaphore, timeout) != pdPASS) {
+        profilerOnTimeout();
+        if (resource->protocol == PROTOCOL_IPCP) {
+            vTaskPrioritySet(NULL, basePriority);
+        }
+        return pdFAIL;
+    }
+
+    TickType_t acquiredAt = xTaskGetTickCount();
+    resource->holder = self;
+    resource->holderBasePriority = basePriority;
+    resource->acquiredAt = acquiredAt;
+    resource->acquiredCounts = hiresNow();
+    profilerOnAcquire(resource, resource->acquiredCounts);
+
+    if (taskIndex < MAX_TASKS) {
+        TickType_t directBlocking = acquiredAt - requestTime;
+
+        taskENTER_CRITICAL();
+        {
+            TickType_t jobBlocking = resource->pendingBlocking[taskIndex] + directBlocking;
+
+            resource->acquisitions[taskIndex]++;
+            resource->basePriority[taskIndex] = basePriority;
+            resource->totalBlocking[taskIndex] += directBlocking;
+            if (jobBlocking > resource->maxBlocking[taskIndex]) {
+                resource->maxBlocking[taskIndex] = jobBlocking;
+            }
+            resource->pendingBlocking[taskIndex] = 0;
+        }
+        taskEXIT_CRITICAL();
+    }
+
+    return pdPASS;
+}
+
+// Under IPCP a higher-priority user is never blocked on the semaphore itself;
+// it is kept from being dispatched while the holder runs at the ceiling. Charge
+// that interval to every task that became ready during the critical section.
+static void chargeCeilingBlocking(ResourceHandle_t resource, TickType_t releasedAt)
+{
+    taskENTER_CRITICAL();
+    {
+        for (UBaseType_t i = 0; i < MAX_TASKS; ++i) {
+            if (taskHandles[i] == NULL || taskHandles[i] == resource->holder || !taskInfo[i].awaitingDispatch) {
+                continue;
+            }
+
+            UBaseType_t priority = uxTaskPriorityGet(taskHandles[i]);
+            if (priority <= resource->holderBasePriority || priority > resource->ceiling) {
+                continue;
+            }
+
+            TickType_t blockedFrom = resource->acquiredAt;
+            if ((int32_t)(taskInfo[i].readyTime - blockedFrom) > 0) {
+                blockedFrom = taskInfo[i].readyTime;
+            }
+
+            resource->pendingBlocking[i] += releasedAt - blockedFrom;
+            resource->totalBlocking[i] += releasedAt - blockedFrom;
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+
+void resourceGive(ResourceHandle_t resource)
+{
+    TickType_t releasedAt = xTaskGetTickCount();
+    UBaseType_t taskIndex = findTaskIndex(resource->holder);
+    UBaseType_t basePriority = resource->holderBasePriority;
+
+    if (taskIndex < MAX_TASKS && releasedAt - resource->acquiredAt > resource->maxHold[taskIndex]) {
+        resource->maxHold[taskIndex] = releasedAt - resource->acquiredAt;
+    }
+
+    profilerOnRelease(resource, hiresNow());
+    if (resource->protocol == PROTOCOL_IPCP) {
+        chargeCeilingBlocking(resource, releasedAt);
+    }
+
+    resource->holder = NULL;
+    xSemaphoreGive(resource->semaphore);
+
+    if (resource->protocol == PROTOCOL_IPCP) {
+        // Return to the base priority; under EDF the rank and under dual priority
+        // the band may have changed meanwhile
+        TaskHandle_t self = xTaskGetCurrentTaskHandle();
+        vTaskPrioritySet(NULL, dualPriorityAssigned(self, edfGetAssignedPriority(self, basePriority)));
+    }
+}
+
+// Print per-task, per-resource blocking next to the IPCP bound: the longest
+// critical section of any lower-priority user of the same resource
+void printResourceBlocking(void)
+{
+    for (UBaseType_t r = 0; r < resourceCount; ++r) {
+        Resource *resource = &resources[r];
+
+        printf("\n==== Resource Blocking: %s (%s, ceiling %lu) ====\n",
+               resource->name, protocolName(resource->protocol), resource->ceiling);
+        printf("Task,Acquisitions,Max Hold (ticks),Total Blocking (ticks),Max Blocking (ticks),Blocking Bound (ticks)\n");
+
+        for (UBaseType_t i = 0; i < MAX_TASKS; ++i) {
+            if (resource->acquisitions[i] == 0 && resource->totalBlocking[i] == 0) {
+                continue;
+            }
+
+            TickType_t bound = 0;
+            for (UBaseType_t j = 0; j < MAX_TASKS; ++j) {
+                if (resource->acquisitions[j] > 0 && resource->basePriority[j] < resource->basePriority[i] &&
+                    resource->maxHold[j] > bound) {
+                    bound = resource->maxHold[j];
+                }
+            }
+
+            printf("\"%s\",%lu,%lu,%lu,%lu,%lu%s\n",
+                   taskInfo[i].taskName,
+                   resource->acquisitions[i],
+                   resource->maxHold[i],
+                   resource->totalBlocking[i],
+                   resource->maxBlocking[i],
+                   bound,
+                   resource->maxBlocking[i] > bound ? " EXCEEDED" : "");
+        }
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef RESOURCE_CEILING_H
+#define RESOURCE_CEILING_H
+
+#include "FreeRTOS.h"
+#include "semphr.h"
+#include "trace_task_switch.h"
+
+#define MAX_RESOURCES 4
+
+// Resource access protocols
+#define PROTOCOL_NONE          0  // Plain binary semaphore, unbounded inversion possible
+#define PROTOCOL_INHERITANCE   1  // FreeRTOS mutex with priority inheritance
+#define PROTOCOL_IPCP          2  // Immediate Priority Ceiling Protocol
+
+// A shared resource guarded by one of the protocols above. The ceiling is the
+// priority of the highest-priority task that uses the resource and is declared
+// when the resource is created.
+typedef struct {
+    const char *name;
+    SemaphoreHandle_t semaphore;
+    UBaseType_t protocol;
+    UBaseType_t ceiling;
+    TaskHandle_t holder;
+    UBaseType_t holderBasePriority;          // Holder priority before the ceiling was applied
+    TickType_t acquiredAt;
+    uint32_t acquiredCounts;                 // High resolution time of acquiredAt
+
+    // Per-task statistics, indexed like taskInfo[]
+    uint32_t acquisitions[MAX_TASKS];
+    UBaseType_t basePriority[MAX_TASKS];     // Priority of the task when it last requested
+    TickType_t pendingBlocking[MAX_TASKS];   // Ceiling blocking charged to the current job
+    TickType_t totalBlocking[MAX_TASKS];
+    TickType_t maxBlocking[MAX_TASKS];
+    TickType_t maxHold[MAX_TASKS];
+} Resource;
+
+typedef Resource * ResourceHandle_t;
+
+ResourceHandle_t resourceCreate(const char *name, UBaseType_t ceiling, UBaseType_t protocol);
+BaseType_t resourceTake(ResourceHandle_t resource, TickType_t timeout);
+void resourceGive(ResourceHandle_t resource);
+void printResourceBlocking(void);
+
+#endif /* RESOURCE_CEILING_H */
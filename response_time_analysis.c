@@ -0,0 +1,333 @@
+#include "response_time_analysis.h"
+#include "trace_task_switch.h"
+#include "tiny_print.h"
+
+static RtaTask rtaTasks[MAX_RTA_TASKS];
+static UBaseType_t rtaTaskCount = 0;
+static BaseType_t rtaFixedPriority = pdTRUE;
+static BaseType_t rtaThresholds = pdFALSE;
+static BaseType_t rtaMixedCriticality = pdFALSE;
+
+void rtaAddTask(const char *name, int taskId, TickType_t computation, TickType_t period,
+                TickType_t deadline, UBaseType_t priority, TickType_t criticalSection)
+{
+    if (rtaTaskCount >= MAX_RTA_TASKS) {
+        printf("RTA task table full, ignoring '%s'\n", name);
+        return;
+    }
+
+    RtaTask *task = &rtaTasks[rtaTaskCount++];
+    task->name = name;
+    task->taskId = taskId;
+    task->computation = computation;
+    task->period = period;
+    task->deadline = deadline;
+    task->jitter = 0;
+    task->criticalSection = criticalSection;
+    task->priority = priority;
+    task->threshold = priority;
+    task->hiCriticality = pdFALSE;
+    task->computationHi = 0;
+    task->blocking = 0;
+    task->response = 0;
+    task->schedulable = pdFALSE;
+}
+
+// A deferrable server can run its budget at the end of one period and again at
+// the start of the next, which is modelled as a periodic task with jitter T - C
+void rtaAddDeferrableServer(const char *name, TickType_t budget, TickType_t period, UBaseType_t priority)
+{
+    rtaAddTask(name, -1, budget, period, period, priority, 0);
+    rtaTasks[rtaTaskCount - 1].jitter = period - budget;
+}
+
+// Preemption threshold of a traced task; a lower-priority job running at or
+// above its threshold blocks the task like a critical section
+void rtaSetThreshold(int taskId, UBaseType_t threshold)
+{
+    for (UBaseType_t i = 0; i < rtaTaskCount; ++i) {
+        if (rtaTasks[i].taskId == taskId && threshold > rtaTasks[i].priority) {
+            rtaTasks[i].threshold = threshold;
+            rtaThresholds = pdTRUE;
+        }
+    }
+}
+
+// Criticality of a traced task. A LO task gives its degraded computation in
+// HI mode, or 0 if it is dropped; tasks left unset are dropped LO tasks.
+void rtaSetCriticality(int taskId, BaseType_t hiCriticality, TickType_t computationHi)
+{
+    for (UBaseType_t i = 0; i < rtaTaskCount; ++i) {
+        if (rtaTasks[i].taskId == taskId) {
+            rtaTasks[i].hiCriticality = hiCriticality;
+            rtaTasks[i].computationHi = computationHi;
+            if (hiCriticality) {
+                rtaMixedCriticality = pdTRUE;
+            }
+        }
+    }
+}
+
+// Longest non-preemptable stretch of a lower-priority job: its whole
+// computation if its threshold reaches the task's priority
+static TickType_t thresholdBlocking(const RtaTask *task)
+{
+    TickType_t blocking = 0;
+
+    for (UBaseType_t j = 0; j < rtaTaskCount; ++j) {
+        const RtaTask *other = &rtaTasks[j];
+
+        if (other->priority < task->priority && other->threshold >= task->priority && other->computation > blocking) {
+            blocking = other->computation;
+        }
+    }
+    return blocking;
+}
+
+// Blocking under a ceiling protocol: the longest critical section of any
+// lower-priority task, provided the task is at or below the resource ceiling
+static TickType_t blockingTerm(const RtaTask *task)
+{
+    UBaseType_t ceiling = 0;
+    TickType_t blocking = 0;
+
+    for (UBaseType_t j = 0; j < rtaTaskCount; ++j) {
+        if (rtaTasks[j].criticalSection > 0 && rtaTasks[j].priority > ceiling) {
+            ceiling = rtaTasks[j].priority;
+        }
+    }
+    if (task->priority > ceiling) {
+        return 0;
+    }
+
+    for (UBaseType_t j = 0; j < rtaTaskCount; ++j) {
+        if (rtaTasks[j].priority < task->priority && rtaTasks[j].criticalSection > blocking) {
+            blocking = rtaTasks[j].criticalSection;
+        }
+    }
+    return blocking;
+}
+
+// Classic fixed-point iteration:
+//   R = C + B + sum over hp(i) of ceil((R + Jj) / Tj) * Cj
+// stopping as soon as R exceeds the deadline
+static void analyzeFixedPriority(RtaTask *task)
+{
+    TickType_t response = task->computation + task->blocking;
+    TickType_t previous = 0;
+
+    while (response != previous && response + task->jitter <= task->deadline) {
+        previous = response;
+        response = task->computation + task->blocking;
+
+        for (UBaseType_t j = 0; j < rtaTaskCount; ++j) {
+            const RtaTask *other = &rtaTasks[j];
+
+            // Equal priorities share the processor by time slicing, so count them as interference
+            if (other == task || other->priority < task->priority) {
+                continue;
+            }
+            response += ((previous + other->jitter + other->period - 1) / other->period) * other->computation;
+        }
+    }
+
+    task->response = response + task->jitter;
+    task->schedulable = task->response <= task->deadline;
+}
+
+// Response time of a HI task across a switch to HI mode (AMC-rtb, Baruah,
+// Burns and Davis). LO tasks interfere only up to the LO-mode response R(LO),
+// plus what they still run in HI mode after it:
+//   R = C(HI) + B + sum over HI hp(i) of ceil(R / Tj) * Cj(HI)
+//       + sum over LO hp(i) of ceil(R(LO) / Tj) * Cj
+//                            + (ceil(R / Tj) - ceil(R(LO) / Tj)) * Cj(HI)
+// Called with the LO-mode response already in task->response.
+static void analyzeHiMode(RtaTask *task)
+{
+    TickType_t responseLo = task->response - task->jitter;
+    TickType_t response = task->computationHi + task->blocking;
+    TickType_t previous = 0;
+
+    while (response != previous && response + task->jitter <= task->deadline) {
+        previous = response;
+        response = task->computationHi + task->blocking;
+
+        for (UBaseType_t j = 0; j < rtaTaskCount; ++j) {
+            const RtaTask *other = &rtaTasks[j];
+            TickType_t jobs = (previous + other->jitter + other->period - 1) / other->period;
+
+            if (other == task || other->priority < task->priority) {
+                continue;
+            }
+            if (other->hiCriticality) {
+                response += jobs * other->computationHi;
+            } else {
+                TickType_t jobsLo = (responseLo + other->jitter + other->period - 1) / other->period;
+
+                response += jobsLo * other->computation;
+                if (jobs > jobsLo) {
+                    response += (jobs - jobsLo) * other->computationHi;
+                }
+            }
+        }
+    }
+
+    if (response + task->jitter > task->response) {
+        task->response = response + task->jitter;
+    }
+    task->schedulable = task->response <= task->deadline;
+}
+
+// Once started, a job is preempted only above its threshold, or by time
+// slicing among equal priorities when it runs at its own priority
+static BaseType_t preemptsStartedJob(const RtaTask *other, const RtaTask *task)
+{
+    return other->priority > task->threshold ||
+           (task->threshold == task->priority && other->priority == task->priority);
+}
+
+// Analysis under preemption thresholds (Wang and Saksena, revised by Keskin
+// et al.). Every job q of the level-i busy period is checked, since a later
+// job can be the worst once lower-priority jobs are non-preemptable:
+//   S(q) = B + q*C + sum over hp(i) of (1 + floor((S(q) + Jj) / Tj)) * Cj
+//   F(q) = S(q) + C + sum over j preempting the started job of
+//          (ceil((F(q) + Jj) / Tj) - 1 - floor((S(q) + Jj) / Tj)) * Cj
+//   R = max over q of F(q) - q*T
+// The busy period ends with the first job finishing before the next release.
+static void analyzeThresholds(RtaTask *task)
+{
+    TickType_t worst = 0;
+
+    for (TickType_t q = 0; worst <= task->deadline; ++q) {
+        TickType_t release = q * task->period;
+        TickType_t start = task->blocking + q * task->computation;
+        TickType_t previous;
+
+        do {
+            previous = start;
+            start = task->blocking + q * task->computation;
+
+            for (UBaseType_t j = 0; j < rtaTaskCount; ++j) {
+                const RtaTask *other = &rtaTasks[j];
+
+                if (other == task || other->priority < task->priority) {
+                    continue;
+                }
+                start += (1 + (previous + other->jitter) / other->period) * other->computation;
+            }
+        } while (start != previous && start <= release + task->deadline);
+
+        TickType_t finish = start + task->computation;
+        do {
+            previous = finish;
+            finish = start + task->computation;
+
+            for (UBaseType_t j = 0; j < rtaTaskCount; ++j) {
+                const RtaTask *other = &rtaTasks[j];
+
+                if (other == task || !preemptsStartedJob(other, task)) {
+                    continue;
+                }
+                finish += ((previous + other->jitter + other->period - 1) / other->period - 1 -
+                           (start + other->jitter) / other->period) * other->computation;
+            }
+        } while (finish != previous && finish + task->jitter <= release + task->deadline);
+
+        if (finish - release + task->jitter > worst) {
+            worst = finish - release + task->jitter;
+        }
+        if (finish <= release + task->period) {
+            break;
+        }
+    }
+
+    task->response = worst;
+    task->schedulable = task->response <= task->deadline;
+}
+
+// Run the analysis for the registered task set. With fixedPriority == pdFALSE the
+// tasks are scheduled by EDF, where the set is schedulable when
+// sum(C/T) + max(B/D) <= 1 and every job then completes by its deadline.
+BaseType_t rtaAnalyze(BaseType_t fixedPriority)
+{
+    BaseType_t allSchedulable = pdTRUE;
+    float utilization = 0.0f;
+    float blockingFactor = 0.0f;
+
+    rtaFixedPriority = fixedPriority;
+
+    for (UBaseType_t i = 0; i < rtaTaskCount; ++i) {
+        RtaTask *task = &rtaTasks[i];
+
+        task->blocking = blockingTerm(task);
+        if (thresholdBlocking(task) > task->blocking) {
+            task->blocking = thresholdBlocking(task);
+        }
+        utilization += (float)task->computation / task->period;
+        if ((float)task->blocking / task->deadline > blockingFactor) {
+            blockingFactor = (float)task->blocking / task->deadline;
+        }
+    }
+
+    for (UBaseType_t i = 0; i < rtaTaskCount; ++i) {
+        RtaTask *task = &rtaTasks[i];
+
+        if (fixedPriority && rtaThresholds) {
+            analyzeThresholds(task);
+        } else if (fixedPriority) {
+            analyzeFixedPriority(task);
+            if (rtaMixedCriticality && task->hiCriticality && task->schedulable) {
+                analyzeHiMode(task);
+            }
+        } else {
+            task->response = task->deadline;
+            task->schedulable = utilization + blockingFactor <= 1.0f;
+        }
+        if (!task->schedulable) {
+            allSchedulable = pdFALSE;
+        }
+    }
+
+    printf("\n==== Response Time Analysis (%s) ====\n", fixedPriority ? "fixed priority" : "EDF");
+    printf("Utilization: %.2f\n", utilization);
+    printf("Task Set Schedulable: %s\n", allSchedulable ? "yes" : "no");
+
+    return allSchedulable;
+}
+
+// Analysed entry of a traced task, or NULL if it was not registered
+const RtaTask *rtaFindTask(int taskId)
+{
+    for (UBaseType_t i = 0; i < rtaTaskCount; ++i) {
+        if (rtaTasks[i].taskId == taskId) {
+            return &rtaTasks[i];
+        }
+    }
+    return NULL;
+}
+
+// Predicted worst-case response times next to the maxima measured by the trace
+void printResponseTimeAnalysis(void)
+{
+    printf("\n==== Predicted vs Measured Response Times (%s) ====\n", rtaFixedPriority ? "fixed priority" : "EDF");
+    printf("Task,C,T,D,B,Predicted R,Measured Max R,Status\n");
+
+    for (UBaseType_t i = 0; i < rtaTaskCount; ++i) {
+        const RtaTask *task = &rtaTasks[i];
+        const char *status = task->schedulable ? "OK" : "UNSCHEDULABLE";
+
+        printf("\"%s\",%lu,%lu,%lu,%lu,%lu,", task->name, task->computation, task->period,
+               task->deadline, task->blocking, task->response);
+
+        if (task->taskId >= 0) {
+            TickType_t measured = getMaxResponseTime((UBaseType_t)task->taskId);
+
+            if (measured > task->response) {
+                status = "VIOLATION";
+            }
+            printf("%lu,%s\n", measured, status);
+        } else {
+            printf("-,%s\n", status);
+        }
+    }
+}
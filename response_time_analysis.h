@@ -0,0 +1,36 @@
+#ifndef RESPONSE_TIME_ANALYSIS_H
+#define RESPONSE_TIME_ANALYSIS_H
+
+#include "FreeRTOS.h"
+#include "trace_task_switch.h"
+
+#define MAX_RTA_TASKS ( MAX_PERIODIC_TASKS + 1 )  // The periodic tasks plus the aperiodic server
+
+// One entry of the analysed task set; all times are in ticks
+typedef struct {
+    const char *name;
+    int taskId;                   // Tracking id for the measured response, -1 if not traced
+    TickType_t computation;       // Worst-case execution time C
+    TickType_t period;            // Period or minimum inter-arrival time T
+    TickType_t deadline;          // Relative deadline D
+    TickType_t jitter;            // Release jitter J
+    TickType_t criticalSection;   // Longest section holding the shared resource
+    UBaseType_t priority;
+    UBaseType_t threshold;        // Preemption threshold, the priority unless set
+    BaseType_t hiCriticality;     // Keeps running in HI mode under mixed criticality
+    TickType_t computationHi;     // C(HI) of a HI task; what a LO task still runs in HI mode
+    TickType_t blocking;          // Computed blocking term B
+    TickType_t response;          // Computed worst-case response time R
+    BaseType_t schedulable;
+} RtaTask;
+
+void rtaAddTask(const char *name, int taskId, TickType_t computation, TickType_t period,
+                TickType_t deadline, UBaseType_t priority, TickType_t criticalSection);
+void rtaAddDeferrableServer(const char *name, TickType_t budget, TickType_t period, UBaseType_t priority);
+void rtaSetThreshold(int taskId, UBaseType_t threshold);
+void rtaSetCriticality(int taskId, BaseType_t hiCriticality, TickType_t computationHi);
+BaseType_t rtaAnalyze(BaseType_t fixedPriority);
+const RtaTask *rtaFindTask(int taskId);
+void printResponseTimeAnalysis(void);
+
+#endif /* RESPONSE_TIME_ANALYSIS_H */
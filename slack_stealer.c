@@ -0,0 +1,316 @@
+#include "slack_stealer.h"
+#include "task_set.h"
+#include "trace_task_switch.h"
+#include "hires_timer.h"
+#include "workload.h"
+#include "aperiodic_response.h"
+#include "tiny_print.h"
+#include "CMSDK_CM3.h"
+#include <task.h>
+
+// Job of a periodic task as last reported by slackJobBegin()/slackJobEnd()
+typedef struct {
+    volatile TickType_t activeRelease;    // Release of the job begun last
+    volatile uint32_t activeStartCounts;  // Execution clock of the task when it began
+    volatile BaseType_t active;           // Begun and not yet ended
+    volatile BaseType_t begun;            // Any job begun yet
+    uint32_t blockingUs;                  // Longest lower-priority critical section that can block it
+} SlackTaskState;
+
+// State of one task when an analysis starts, in microseconds relative to then
+typedef struct {
+    uint32_t pendingUs;        // Released work not yet executed
+    uint32_t pendingJobs;      // Released jobs not yet ended
+    uint32_t firstWorkUs;      // Work left of its first job, pending or future
+    int32_t firstReleaseUs;    // Release of that job
+    int32_t nextReleaseUs;     // First release after the analysis starts
+} SlackSnapshot;
+
+static SlackTaskState slackTasks[MAX_PERIODIC_TASKS];
+static SlackSnapshot snapshot[MAX_PERIODIC_TASKS];
+
+static uint32_t slackAnalyses = 0;
+static uint32_t slackZeroAnalyses = 0;
+static uint32_t slackAnalysisTotalUs = 0;
+static uint32_t slackAnalysisMaxUs = 0;
+static uint32_t slackStolenUs = 0;
+static uint32_t slackBackgroundUs = 0;
+
+// Blocking bounds under the ceiling of the shared resource; call after
+// taskSetLoad() and before the scheduler starts
+void slackStealerInit(void)
+{
+    UBaseType_t ceiling = taskSetResourceCeiling();
+
+    for (UBaseType_t i = 0; i < periodicTaskCount; ++i) {
+        uint32_t blocking = 0;
+
+        for (UBaseType_t j = 0; j < periodicTaskCount && periodicTasks[i].priority <= ceiling; ++j) {
+            if (periodicTasks[j].priority < periodicTasks[i].priority && periodicTasks[j].criticalSectionUs > blocking) {
+                blocking = periodicTasks[j].criticalSectionUs;
+            }
+        }
+        slackTasks[i].blockingUs = blocking;
+        slackTasks[i].active = pdFALSE;
+        slackTasks[i].begun = pdFALSE;
+    }
+}
+
+// Called by a periodic task as its job starts. The fields are written in an
+// order under which an analysis preempting the update can only overcount work.
+void slackJobBegin(int taskId, TickType_t releaseTime)
+{
+    SlackTaskState *state = &slackTasks[taskId - PERIODIC_TASK_ID(0)];
+
+    state->activeStartCounts = getTaskExecutionCounts((UBaseType_t)taskId);
+    state->activeRelease = releaseTime;
+    state->active = pdTRUE;
+    state->begun = pdTRUE;
+}
+
+void slackJobEnd(int taskId)
+{
+    slackTasks[taskId - PERIODIC_TASK_ID(0)].active = pdFALSE;
+}
+
+// Current time in microseconds of the tick time base, with the part of the
+// current tick read from SysTick. Retried when a tick lands between the reads.
+static uint32_t slackNowUs(TickType_t *tick)
+{
+    TickType_t before;
+    uint32_t elapsedCycles;
+
+    do {
+        before = xTaskGetTickCount();
+        elapsedCycles = SysTick->LOAD - SysTick->VAL;
+    } while (before != xTaskGetTickCount() || (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0);
+
+    *tick = before;
+    return before * US_PER_TICK + (uint32_t)(((uint64_t)elapsedCycles * US_PER_TICK) / (SysTick->LOAD + 1));
+}
+
+static void takeSnapshot(TickType_t now, uint32_t nowUs)
+{
+    for (UBaseType_t i = 0; i < periodicTaskCount; ++i) {
+        const PeriodicTask *task = &periodicTasks[i];
+        const SlackTaskState *state = &slackTasks[i];
+        SlackSnapshot *snap = &snapshot[i];
+        uint32_t released = now >= task->offset ? (now - task->offset) / task->period + 1 : 0;
+        uint32_t begunJobs = state->begun ? (state->activeRelease - task->offset) / task->period + 1 : 0;
+        uint32_t unbegun = released > begunJobs ? released - begunJobs : 0;
+        uint32_t activeWorkUs = 0;
+
+        if (state->active) {
+            uint32_t executedUs = hiresCountsToUs(getTaskExecutionCounts((UBaseType_t)task->taskId) - state->activeStartCounts);
+
+            activeWorkUs = task->computationUs > executedUs ? task->computationUs - executedUs : 0;
+        }
+
+        snap->pendingUs = activeWorkUs + unbegun * task->computationUs;
+        snap->pendingJobs = (state->active ? 1 : 0) + unbegun;
+        snap->nextReleaseUs = (int32_t)((task->offset + released * task->period) * US_PER_TICK - nowUs);
+        if (state->active) {
+            snap->firstWorkUs = activeWorkUs;
+            snap->firstReleaseUs = (int32_t)(state->activeRelease * US_PER_TICK - nowUs);
+        } else {
+            snap->firstWorkUs = task->computationUs;
+            snap->firstReleaseUs = unbegun > 0 ? (int32_t)((task->offset + begunJobs * task->period) * US_PER_TICK - nowUs)
+                                               : snap->nextReleaseUs;
+        }
+    }
+}
+
+static BaseType_t interferes(UBaseType_t j, UBaseType_t i)
+{
+    // Equal priorities share the processor by time slicing, so count them as interference
+    return j != i && periodicTasks[j].priority >= periodicTasks[i].priority;
+}
+
+// Work of the tasks interfering with task i that is pending now or released before w
+static uint32_t interference(UBaseType_t i, int32_t w)
+{
+    uint32_t work = 0;
+
+    for (UBaseType_t j = 0; j < periodicTaskCount; ++j) {
+        int32_t periodUs = (int32_t)(periodicTasks[j].period * US_PER_TICK);
+
+        if (!interferes(j, i)) {
+            continue;
+        }
+        work += snapshot[j].pendingUs;
+        if (w > snapshot[j].nextReleaseUs) {
+            work += ((uint32_t)(w - snapshot[j].nextReleaseUs - 1) / periodUs + 1) * periodicTasks[j].computationUs;
+        }
+    }
+    return work;
+}
+
+// Largest stolen execution x with which a job of task i, released at
+// releaseUs, still completes by deadlineUs: the job is done at the first w with
+// x + demand + interference(w) <= w, so x is the maximum of
+// w - interference(w) - demand over the releases of the interfering tasks in
+// the window, where it peaks, and the deadline. Returns early once the result
+// cannot fall below bound.
+static int32_t jobSlack(UBaseType_t i, int32_t releaseUs, int32_t deadlineUs, uint32_t demand, int32_t bound)
+{
+    int32_t best = deadlineUs - (int32_t)(interference(i, deadlineUs) + demand);
+    int32_t start = releaseUs > 0 ? releaseUs : 0;
+
+    for (UBaseType_t j = 0; j < periodicTaskCount && best < bound; ++j) {
+        int32_t periodUs = (int32_t)(periodicTasks[j].period * US_PER_TICK);
+        int32_t release = snapshot[j].nextReleaseUs;
+
+        if (!interferes(j, i)) {
+            continue;
+        }
+        if (release <= start) {
+            release += ((start - release) / periodUs + 1) * periodUs;
+        }
+        for (; release < deadlineUs && best < bound; release += periodUs) {
+            int32_t candidate = release - (int32_t)(interference(i, release) + demand);
+
+            if (candidate > best) {
+                best = candidate;
+            }
+        }
+    }
+    return best;
+}
+
+// Whether the level-i work demand, with the interference it attracts, runs up
+// to releaseUs, so the job released then joins the same busy period
+static BaseType_t busyUntil(UBaseType_t i, uint32_t demand, int32_t releaseUs)
+{
+    int32_t w = (int32_t)demand;
+
+    for (;;) {
+        int32_t next = (int32_t)(demand + interference(i, w));
+
+        if (next >= releaseUs) {
+            return pdTRUE;
+        }
+        if (next == w) {
+            return pdFALSE;
+        }
+        w = next;
+    }
+}
+
+// Slack at the level of task i: the minimum job slack over its jobs in the
+// current busy period, which ends once its work completes before its next release
+static int32_t levelSlack(UBaseType_t i, int32_t bound)
+{
+    const PeriodicTask *task = &periodicTasks[i];
+    const SlackSnapshot *own = &snapshot[i];
+    const int32_t periodUs = (int32_t)(task->period * US_PER_TICK);
+    const int32_t deadlineUs = (int32_t)(task->deadline * US_PER_TICK);
+    int32_t releaseUs = own->firstReleaseUs;
+    uint32_t demand = slackTasks[i].blockingUs + own->firstWorkUs;
+    int32_t slack = bound;
+
+    for (uint32_t job = 0; job < SLACK_MAX_JOBS_PER_LEVEL; ++job) {
+        int32_t jobBound = jobSlack(i, releaseUs, releaseUs + deadlineUs, demand, slack);
+
+        if (jobBound < slack) {
+            slack = jobBound;
+        }
+        if (slack <= 0) {
+            return 0;
+        }
+        if (job + 1 >= own->pendingJobs && !busyUntil(i, (uint32_t)slack + demand, releaseUs + periodUs)) {
+            return slack;
+        }
+        releaseUs += periodUs;
+        demand += task->computationUs;
+    }
+
+    // Busy period too long to follow: assume no slack
+    return 0;
+}
+
+// Execution available at the top priority from now on without a periodic job
+// missing its deadline, less the time of the analysis itself and a margin.
+// Call at the top priority, so no periodic job runs during the analysis.
+uint32_t slackAvailableUs(void)
+{
+    uint32_t startCounts = hiresNow();
+    TickType_t now;
+    uint32_t nowUs = slackNowUs(&now);
+    int32_t slack = INT32_MAX;
+
+    takeSnapshot(now, nowUs);
+    for (UBaseType_t i = 0; i < periodicTaskCount && slack > 0; ++i) {
+        slack = levelSlack(i, slack);
+    }
+
+    uint32_t analysisUs = hiresCountsToUs(hiresNow() - startCounts);
+    uint32_t reserveUs = analysisUs + SLACK_MARGIN_US;
+
+    slackAnalyses++;
+    slackAnalysisTotalUs += analysisUs;
+    if (analysisUs > slackAnalysisMaxUs) {
+        slackAnalysisMaxUs = analysisUs;
+    }
+    if (slack <= (int32_t)reserveUs) {
+        slackZeroAnalyses++;
+        return 0;
+    }
+    return (uint32_t)slack - reserveUs;
+}
+
+// Serve the queued jobs at the top priority while slack lasts, in the
+// background otherwise. The server waits at the top priority so an arrival is
+// analysed at once, and every analysis is made at that priority.
+void slackServerTask(void *pvParameters)
+{
+    const SlackServerConfig *config = (const SlackServerConfig *)pvParameters;
+    AperiodicJob *job;
+
+    for (;;)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        while ((job = aperiodicQueuePop(config->jobQueue)) != NULL)
+        {
+            aperiodicJobStart(job);
+            while (job->computationUs > 0)
+            {
+                vTaskPrioritySet(NULL, config->topPriority);
+
+                uint32_t slackUs = slackAvailableUs();
+                uint32_t slice;
+
+                if (slackUs >= SLACK_MIN_SLICE_US)
+                {
+                    slice = job->computationUs < slackUs ? job->computationUs : slackUs;
+                    slackStolenUs += slice;
+                }
+                else
+                {
+                    // No slack: continue in the idle time of the periodic tasks
+                    slice = job->computationUs < SLACK_BACKGROUND_SLICE_US ? job->computationUs : SLACK_BACKGROUND_SLICE_US;
+                    vTaskPrioritySet(NULL, config->backgroundPriority);
+                    slackBackgroundUs += slice;
+                }
+
+                deferredServerActive = pdTRUE;
+                burnExecutionTime(slice);
+                deferredServerActive = pdFALSE;
+                job->computationUs -= slice;
+            }
+            aperiodicJobComplete(job);
+            aperiodicJobFree(job);
+        }
+        vTaskPrioritySet(NULL, config->topPriority);
+    }
+}
+
+void printSlackStealerStats(void)
+{
+    printf("Slack Analyses: %lu\n", slackAnalyses);
+    printf("Analyses Without Slack: %lu\n", slackZeroAnalyses);
+    printf("Analysis Time Mean (us): %lu\n", slackAnalyses ? slackAnalysisTotalUs / slackAnalyses : 0);
+    printf("Analysis Time Max (us): %lu\n", slackAnalysisMaxUs);
+    printf("Served on Slack (us): %lu\n", slackStolenUs);
+    printf("Served in Background (us): %lu\n", slackBackgroundUs);
+}
@@ -0,0 +1,31 @@
+#ifndef SLACK_STEALER_H
+#define SLACK_STEALER_H
+
+#include "FreeRTOS.h"
+#include "aperiodic_job.h"
+
+// Slack stealing server for the fixed-priority periodic tasks. Whenever jobs
+// are queued the server computes the slack of the task set, the execution that
+// can be spent at the top priority without any periodic job missing its
+// deadline, and serves the jobs at that priority for as long as slack remains.
+// Without slack it serves them in the background, below every periodic task.
+#define SLACK_MIN_SLICE_US          200   // Less slack than this is not worth a priority change
+#define SLACK_MARGIN_US             100   // Reserve for interrupts taken while serving
+#define SLACK_BACKGROUND_SLICE_US   1000  // Work between slack checks in the background
+#define SLACK_MAX_JOBS_PER_LEVEL    16    // Jobs of one task checked per analysis; beyond it no slack is assumed
+
+// Slack stealing server parameters, passed to slackServerTask() as pvParameters
+typedef struct {
+    AperiodicJobQueue *jobQueue;      // Source of AperiodicJob requests
+    UBaseType_t topPriority;          // Priority while stealing slack, above every periodic task
+    UBaseType_t backgroundPriority;   // Priority while no slack is available
+} SlackServerConfig;
+
+void slackStealerInit(void);
+void slackJobBegin(int taskId, TickType_t releaseTime);
+void slackJobEnd(int taskId);
+uint32_t slackAvailableUs(void);
+void slackServerTask(void *pvParameters);
+void printSlackStealerStats(void);
+
+#endif /* SLACK_STEALER_H */
@@ -35,10 +35,8 @@ void vApplicationSetupInterrupts(void)
     NVIC_SetPriority(TIMER1_IRQn, configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY + 1);
     NVIC_EnableIRQ(TIMER1_IRQn);
 
-    // UART RX/TX with lower priority than Timer0/Timer1
+    // UART RX/TX with lower priority than Timer0/Timer1. The UART is polled and
+    // has no handlers in the vector table, so its lines stay disabled.
     NVIC_SetPriority(UARTRX0_IRQn, configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY + 2);
-    NVIC_EnableIRQ(UARTRX0_IRQn);
-
     NVIC_SetPriority(UARTTX0_IRQn, configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY + 2);
-    NVIC_EnableIRQ(UARTTX0_IRQn);
 }
@@ -0,0 +1,310 @@
+#include "task_chain.h"
+#include "task_set.h"
+#include "response_time_analysis.h"
+#include "hires_timer.h"
+#include "workload.h"
+#include "tiny_print.h"
+#include <string.h>
+
+// One row of CHAIN_FILE: the chain and its stages, first to last
+typedef struct {
+    const char *name;
+    const char *stages[MAX_CHAIN_STAGES];
+} ChainEntry;
+
+// Each line of CHAIN_FILE is one TASK_CHAIN(name, stage, ...) row
+static const ChainEntry chainTable[] = {
+#define TASK_CHAIN(name, ...) { name, { __VA_ARGS__ } },
+#include CHAIN_FILE
+#undef TASK_CHAIN
+};
+
+#define CHAIN_TABLE_SIZE ( sizeof(chainTable) / sizeof(chainTable[0]) )
+
+// Triple buffer between a stage and the next: the writer fills the back slot
+// and swaps it with the middle one to publish; the reader swaps the middle
+// slot to the front when a newer sample is there. Neither side ever waits,
+// and a slot is never written while it is being read.
+typedef struct {
+    ChainSample slots[3];
+    uint8_t back;
+    uint8_t middle;
+    uint8_t front;
+    BaseType_t fresh;        // The middle slot holds a sample the reader has not taken
+} ChainBuffer;
+
+typedef struct {
+    const char *name;
+    UBaseType_t stageCount;
+    const PeriodicTask *stages[MAX_CHAIN_STAGES];
+    ChainBuffer links[MAX_CHAIN_STAGES - 1];  // links[s] carries the samples of stage s to stage s + 1
+    uint32_t nextSequence;
+
+    // Measured at the last stage, in high resolution counts
+    uint32_t outputs;
+    uint32_t freshOutputs;   // Outputs of a sample not output before
+    uint32_t lostSamples;    // Samples of the first stage that never reached the output
+    uint32_t lastSequence;
+    uint32_t lastOriginCounts;
+    uint64_t latencyTotal;
+    uint32_t latencyMax;
+    uint32_t ageMax;
+    uint32_t reactionMax;
+} TaskChain;
+
+// Place of a task in its chain, and the samples of its current job
+typedef struct {
+    TaskChain *chain;        // NULL if the task is in no chain
+    UBaseType_t stage;
+    const ChainSample *input;
+    ChainSample *output;
+} ChainRole;
+
+static TaskChain chains[MAX_CHAINS];
+static UBaseType_t chainCount = 0;
+static ChainRole roles[MAX_TASKS];
+static UBaseType_t chainSemantics = CHAIN_NONE;
+
+static const PeriodicTask *findPeriodicTask(const char *name)
+{
+    for (UBaseType_t i = 0; i < periodicTaskCount; ++i) {
+        if (strcmp(periodicTasks[i].config->name, name) == 0) {
+            return &periodicTasks[i];
+        }
+    }
+    return NULL;
+}
+
+static void bufferInit(ChainBuffer *buffer)
+{
+    memset(buffer, 0, sizeof(*buffer));
+    buffer->back = 0;
+    buffer->middle = 1;
+    buffer->front = 2;
+}
+
+static void bufferPublish(ChainBuffer *buffer)
+{
+    taskENTER_CRITICAL();
+    {
+        uint8_t slot = buffer->middle;
+        buffer->middle = buffer->back;
+        buffer->back = slot;
+        buffer->fresh = pdTRUE;
+    }
+    taskEXIT_CRITICAL();
+}
+
+static const ChainSample *bufferLatest(ChainBuffer *buffer)
+{
+    taskENTER_CRITICAL();
+    {
+        if (buffer->fresh) {
+            uint8_t slot = buffer->front;
+            buffer->front = buffer->middle;
+            buffer->middle = slot;
+            buffer->fresh = pdFALSE;
+        }
+    }
+    taskEXIT_CRITICAL();
+    return &buffer->slots[buffer->front];
+}
+
+// Resolve the chains against the task set. A chain needs two stages or more,
+// all in the table, and a task may be a stage of one chain only. A later stage
+// of an activation-triggered chain runs at the first stage's rate, while the
+// priorities, the analysis and the deadline monitor use its table period, so
+// the two must be equal. Call after taskSetLoad(); the stages are notified
+// through the handles of periodicTasks.
+void chainsLoad(UBaseType_t semantics)
+{
+    chainSemantics = semantics;
+    chainCount = 0;
+    if (semantics == CHAIN_NONE) {
+        return;
+    }
+
+    for (UBaseType_t i = 0; i < CHAIN_TABLE_SIZE && chainCount < MAX_CHAINS; ++i) {
+        const ChainEntry *entry = &chainTable[i];
+        TaskChain *chain = &chains[chainCount];
+        BaseType_t valid = pdTRUE;
+
+        memset(chain, 0, sizeof(*chain));
+        chain->name = entry->name;
+        for (UBaseType_t s = 0; s < MAX_CHAIN_STAGES && entry->stages[s] != NULL; ++s) {
+            const PeriodicTask *task = findPeriodicTask(entry->stages[s]);
+
+            if (task == NULL || roles[task->taskId].chain != NULL ||
+                (semantics == CHAIN_ACTIVATION_TRIGGERED && s > 0 &&
+                 task->config->periodMs != chain->stages[0]->config->periodMs)) {
+                valid = pdFALSE;
+                break;
+            }
+            chain->stages[chain->stageCount++] = task;
+        }
+        if (!valid || chain->stageCount < 2) {
+            printf("Chain entry rejected: Chain='%s'\n", entry->name);
+            configASSERT(0);
+            continue;
+        }
+
+        for (UBaseType_t s = 0; s < chain->stageCount; ++s) {
+            roles[chain->stages[s]->taskId].chain = chain;
+            roles[chain->stages[s]->taskId].stage = s;
+            if (s + 1 < chain->stageCount) {
+                bufferInit(&chain->links[s]);
+            }
+        }
+        chainCount++;
+    }
+}
+
+// Stages after the first of an activation-triggered chain wait for their
+// predecessor instead of following their period
+BaseType_t chainActivationTriggered(int taskId)
+{
+    return chainSemantics == CHAIN_ACTIVATION_TRIGGERED && roles[taskId].chain != NULL && roles[taskId].stage > 0;
+}
+
+// Block until the previous stage completes a job; returns the release time.
+// Activations that arrive while a job runs are merged into the next one.
+TickType_t chainWaitActivation(void)
+{
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    return xTaskGetTickCount();
+}
+
+// Called when the job starts: take the latest input sample and fill the
+// output slot from it in place. The first stage takes a new sample.
+void chainJobBegin(int taskId)
+{
+    ChainRole *role = &roles[taskId];
+    TaskChain *chain = role->chain;
+
+    if (chain == NULL) {
+        return;
+    }
+
+    role->input = role->stage > 0 ? bufferLatest(&chain->links[role->stage - 1]) : NULL;
+    role->output = role->stage + 1 < chain->stageCount ? &chain->links[role->stage].slots[chain->links[role->stage].back] : NULL;
+    if (role->output == NULL) {
+        return;
+    }
+
+    if (role->input == NULL) {
+        role->output->sequence = ++chain->nextSequence;
+        role->output->originCounts = hiresNow();
+        for (UBaseType_t i = 0; i < CHAIN_PAYLOAD_WORDS; ++i) {
+            role->output->payload[i] = role->output->sequence + i;
+        }
+    } else {
+        // A two-tap smoothing step stands in for the stage's processing
+        role->output->sequence = role->input->sequence;
+        role->output->originCounts = role->input->originCounts;
+        for (UBaseType_t i = 0; i < CHAIN_PAYLOAD_WORDS; ++i) {
+            role->output->payload[i] = (role->input->payload[i] + role->input->payload[(i + 1) % CHAIN_PAYLOAD_WORDS]) / 2;
+        }
+    }
+}
+
+// Called when the job ends: publish the output and, for an activation-
+// triggered chain, release the next stage. The last stage records the age of
+// the sample it acted on; the first time a sample reaches it, also its
+// end-to-end latency and the reaction time to an event just after the
+// previous sample it acted on.
+void chainJobEnd(int taskId)
+{
+    ChainRole *role = &roles[taskId];
+    TaskChain *chain = role->chain;
+
+    if (chain == NULL) {
+        return;
+    }
+
+    if (role->output != NULL) {
+        bufferPublish(&chain->links[role->stage]);
+        if (chainSemantics == CHAIN_ACTIVATION_TRIGGERED) {
+            xTaskNotifyGive(chain->stages[role->stage + 1]->handle);
+        }
+        return;
+    }
+
+    if (role->input == NULL || role->input->sequence == 0) {
+        return;  // Nothing has reached the last stage yet
+    }
+
+    uint32_t now = hiresNow();
+    uint32_t age = now - role->input->originCounts;
+
+    chain->outputs++;
+    if (age > chain->ageMax) {
+        chain->ageMax = age;
+    }
+    if (role->input->sequence == chain->lastSequence) {
+        return;
+    }
+
+    chain->freshOutputs++;
+    chain->latencyTotal += age;
+    if (age > chain->latencyMax) {
+        chain->latencyMax = age;
+    }
+    if (chain->lastSequence != 0) {
+        uint32_t reaction = now - chain->lastOriginCounts;
+
+        chain->lostSamples += role->input->sequence - chain->lastSequence - 1;
+        if (reaction > chain->reactionMax) {
+            chain->reactionMax = reaction;
+        }
+    }
+    chain->lastSequence = role->input->sequence;
+    chain->lastOriginCounts = role->input->originCounts;
+}
+
+// Worst-case reaction time from the boot-time analysis: the sum of T + R over
+// the stages when every stage samples its input (Davare et al.), the first
+// period plus the sum of R when each completion releases the next stage
+static uint32_t reactionBoundUs(const TaskChain *chain)
+{
+    TickType_t bound = chainSemantics == CHAIN_ACTIVATION_TRIGGERED ? chain->stages[0]->period : 0;
+
+    for (UBaseType_t s = 0; s < chain->stageCount; ++s) {
+        const RtaTask *rta = rtaFindTask(chain->stages[s]->taskId);
+
+        bound += rta != NULL ? rta->response : chain->stages[s]->deadline;
+        if (chainSemantics == CHAIN_PERIOD_TRIGGERED) {
+            bound += chain->stages[s]->period;
+        }
+    }
+    return bound * US_PER_TICK;
+}
+
+void printTaskChains(void)
+{
+    if (chainCount == 0) {
+        return;
+    }
+
+    printf("\n==== Task Chains (%s) ====\n",
+           chainSemantics == CHAIN_ACTIVATION_TRIGGERED ? "activation-triggered" : "period-triggered");
+    printf("Chain,Stages,Outputs,Fresh Outputs,Lost Samples,Mean Latency (us),Max Latency (us),"
+           "Max Data Age (us),Max Reaction (us),Reaction Bound (us)\n");
+
+    for (UBaseType_t c = 0; c < chainCount; ++c) {
+        const TaskChain *chain = &chains[c];
+
+        printf("\"%s\",", chain->name);
+        for (UBaseType_t s = 0; s < chain->stageCount; ++s) {
+            printf("%s%s", s > 0 ? ">" : "", chain->stages[s]->config->name);
+        }
+        printf(",%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu\n",
+               chain->outputs,
+               chain->freshOutputs,
+               chain->lostSamples,
+               hiresCountsToUs(chain->freshOutputs ? (uint32_t)(chain->latencyTotal / chain->freshOutputs) : 0),
+               hiresCountsToUs(chain->latencyMax),
+               hiresCountsToUs(chain->ageMax),
+               hiresCountsToUs(chain->reactionMax),
+               reactionBoundUs(chain));
+    }
+}
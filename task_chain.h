@@ -0,0 +1,40 @@
+#ifndef TASK_CHAIN_H
+#define TASK_CHAIN_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "trace_task_switch.h"
+
+// Cause-effect chains of periodic tasks, e.g. sensor -> filter -> control ->
+// actuate. Each stage reads the latest sample of the previous stage when its
+// job starts and publishes its own when the job ends. Samples are handed over
+// in place through a triple buffer per link, never copied. The chains are
+// given by task name in CHAIN_FILE; override with -DCHAIN_FILE=\"chains/<name>.h\"
+#ifndef CHAIN_FILE
+#define CHAIN_FILE "chains/default.h"
+#endif
+
+// How the stages after the first one are released
+#define CHAIN_NONE                         0  // No chains, the tasks are independent
+#define CHAIN_PERIOD_TRIGGERED             1  // Every stage keeps its own period and samples its input
+#define CHAIN_ACTIVATION_TRIGGERED         2  // The first stage is periodic, each completion releases the next stage
+
+#define MAX_CHAINS                         4
+#define MAX_CHAIN_STAGES                   6
+#define CHAIN_PAYLOAD_WORDS                16
+
+// One sample travelling down a chain
+typedef struct {
+    uint32_t sequence;       // Numbered by the first stage from 1; 0 until it has published
+    uint32_t originCounts;   // High resolution time at which the first stage took the sample
+    uint32_t payload[CHAIN_PAYLOAD_WORDS];
+} ChainSample;
+
+void chainsLoad(UBaseType_t semantics);
+BaseType_t chainActivationTriggered(int taskId);
+TickType_t chainWaitActivation(void);
+void chainJobBegin(int taskId);
+void chainJobEnd(int taskId);
+void printTaskChains(void);
+
+#endif /* TASK_CHAIN_H */
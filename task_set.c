@@ -0,0 +1,152 @@
+#include "task_set.h"
+#include "tiny_print.h"
+
+// Each line of TASK_SET_FILE is one TASK_SET_ENTRY(...) row
+static const PeriodicTaskConfig taskSetTable[] = {
+#define TASK_SET_ENTRY(name, periodMs, wcetUs, deadlineMs, offsetMs, criticalSectionUs, stackDepth, criticality, wcetHiUs, workload) \
+    { name, periodMs, wcetUs, deadlineMs, offsetMs, criticalSectionUs, stackDepth, criticality, wcetHiUs, workload },
+#include TASK_SET_FILE
+#undef TASK_SET_ENTRY
+};
+
+#define TASK_SET_TABLE_SIZE ( sizeof(taskSetTable) / sizeof(taskSetTable[0]) )
+
+PeriodicTask periodicTasks[MAX_PERIODIC_TASKS];
+UBaseType_t periodicTaskCount = 0;
+
+static UBaseType_t priorityAssignment = PRIORITY_RATE_MONOTONIC;
+
+static TickType_t priorityKey(const PeriodicTask *task)
+{
+    return priorityAssignment == PRIORITY_DEADLINE_MONOTONIC ? task->deadline : task->period;
+}
+
+// Resolve the table to ticks and assign fixed priorities. Every distinct period
+// (or deadline) gets its own level counting up from PERIODIC_LOWEST_PRIORITY,
+// longest first; tasks with equal keys share a level.
+void taskSetLoad(UBaseType_t assignment)
+{
+    priorityAssignment = assignment;
+    periodicTaskCount = 0;
+
+    for (UBaseType_t i = 0; i < TASK_SET_TABLE_SIZE; ++i) {
+        const PeriodicTaskConfig *config = &taskSetTable[i];
+
+        if (periodicTaskCount >= MAX_PERIODIC_TASKS || config->periodMs == 0 || config->wcetUs == 0) {
+            printf("Task set entry rejected: Name='%s', Period=%lu ms, WCET=%lu us\n",
+                   config->name, config->periodMs, config->wcetUs);
+            configASSERT(0);
+            continue;
+        }
+
+        PeriodicTask *task = &periodicTasks[periodicTaskCount];
+        task->config = config;
+        task->taskId = PERIODIC_TASK_ID(periodicTaskCount);
+        task->period = pdMS_TO_TICKS(config->periodMs);
+        task->computation = TASK_US_TO_TICKS(config->wcetUs);
+        task->deadline = pdMS_TO_TICKS(config->deadlineMs ? config->deadlineMs : config->periodMs);
+        task->offset = pdMS_TO_TICKS(config->offsetMs);
+        task->computationUs = config->wcetUs;
+        task->computationHiUs = config->criticality == CRITICALITY_HI && config->wcetHiUs > config->wcetUs ?
+                                config->wcetHiUs : config->wcetUs;
+        task->computationHi = TASK_US_TO_TICKS(task->computationHiUs);
+        task->criticalSectionUs = config->criticalSectionUs < config->wcetUs ? config->criticalSectionUs : config->wcetUs;
+        task->criticalSection = TASK_US_TO_TICKS(task->criticalSectionUs);
+        task->handle = NULL;
+        periodicTaskCount++;
+    }
+
+    for (UBaseType_t i = 0; i < periodicTaskCount; ++i) {
+        UBaseType_t longerKeys = 0;
+
+        for (UBaseType_t j = 0; j < periodicTaskCount; ++j) {
+            BaseType_t firstWithKey = pdTRUE;
+
+            if (priorityKey(&periodicTasks[j]) <= priorityKey(&periodicTasks[i])) {
+                continue;
+            }
+            for (UBaseType_t k = 0; k < j; ++k) {
+                if (priorityKey(&periodicTasks[k]) == priorityKey(&periodicTasks[j])) {
+                    firstWithKey = pdFALSE;
+                    break;
+                }
+            }
+            longerKeys += firstWithKey;
+        }
+        periodicTasks[i].priority = PERIODIC_LOWEST_PRIORITY + longerKeys;
+    }
+}
+
+// Give a periodic server the level its period would get in the task set. Tasks
+// with a shorter period (or deadline) move up one level to make room, unless a
+// task already has the server's period, whose level the server then shares.
+// Returns the server's priority; the band grows by at most one level.
+UBaseType_t taskSetPlaceServer(TickType_t serverPeriod)
+{
+    UBaseType_t serverPriority = PERIODIC_LOWEST_PRIORITY;
+    BaseType_t sharedLevel = pdFALSE;
+
+    for (UBaseType_t j = 0; j < periodicTaskCount; ++j) {
+        BaseType_t firstWithKey = pdTRUE;
+
+        if (priorityKey(&periodicTasks[j]) == serverPeriod) {
+            sharedLevel = pdTRUE;
+        }
+        if (priorityKey(&periodicTasks[j]) <= serverPeriod) {
+            continue;
+        }
+        for (UBaseType_t k = 0; k < j; ++k) {
+            if (priorityKey(&periodicTasks[k]) == priorityKey(&periodicTasks[j])) {
+                firstWithKey = pdFALSE;
+                break;
+            }
+        }
+        serverPriority += firstWithKey;
+    }
+
+    if (!sharedLevel) {
+        for (UBaseType_t i = 0; i < periodicTaskCount; ++i) {
+            if (priorityKey(&periodicTasks[i]) < serverPeriod) {
+                periodicTasks[i].priority++;
+            }
+        }
+    }
+    return serverPriority;
+}
+
+// Highest fixed priority of any task that uses the shared resource
+UBaseType_t taskSetResourceCeiling(void)
+{
+    UBaseType_t ceiling = PERIODIC_LOWEST_PRIORITY;
+
+    for (UBaseType_t i = 0; i < periodicTaskCount; ++i) {
+        if (periodicTasks[i].criticalSection > 0 && periodicTasks[i].priority > ceiling) {
+            ceiling = periodicTasks[i].priority;
+        }
+    }
+    return ceiling;
+}
+
+void printTaskSet(void)
+{
+    printf("\n==== Task Set: %s (%s) ====\n", TASK_SET_FILE,
+           priorityAssignment == PRIORITY_DEADLINE_MONOTONIC ? "deadline monotonic" : "rate monotonic");
+    printf("Task,Priority,Period (ms),WCET (us),Deadline (ms),Offset (ms),Critical Section (us),Criticality,HI WCET (us),Workload\n");
+
+    for (UBaseType_t i = 0; i < periodicTaskCount; ++i) {
+        const PeriodicTask *task = &periodicTasks[i];
+        const PeriodicTaskConfig *config = task->config;
+
+        printf("\"%s\",%lu,%lu,%lu,%lu,%lu,%lu,%s,%lu,%s\n",
+               config->name,
+               task->priority,
+               config->periodMs,
+               config->wcetUs,
+               config->deadlineMs ? config->deadlineMs : config->periodMs,
+               config->offsetMs,
+               config->criticalSectionUs,
+               config->criticality == CRITICALITY_HI ? "HI" : "LO",
+               task->computationHiUs,
+               workloadName(config->workload));
+    }
+}
@@ -0,0 +1,66 @@
+#ifndef TASK_SET_H
+#define TASK_SET_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "trace_task_switch.h"
+#include "workload.h"
+
+// Table compiled into the image; override with -DTASK_SET_FILE=\"task_sets/<name>.h\"
+#ifndef TASK_SET_FILE
+#define TASK_SET_FILE "task_sets/default.h"
+#endif
+
+// Criticality level of a periodic task
+#define CRITICALITY_LO                     0
+#define CRITICALITY_HI                     1
+
+// Fixed-priority assignment for the periodic tasks
+#define PRIORITY_RATE_MONOTONIC            0  // Shorter period, higher priority
+#define PRIORITY_DEADLINE_MONOTONIC        1  // Shorter relative deadline, higher priority
+
+// Microseconds rounded up to whole ticks, for the analysis
+#define TASK_US_TO_TICKS(us) ( ( TickType_t ) ( ( ( uint64_t ) ( us ) * configTICK_RATE_HZ + 999999u ) / 1000000u ) )
+
+// One row of the task set table, as written in TASK_SET_FILE
+typedef struct {
+    const char *name;
+    uint32_t periodMs;
+    uint32_t wcetUs;              // Worst-case execution time C
+    uint32_t deadlineMs;          // Relative deadline D, 0 for an implicit deadline (D = T)
+    uint32_t offsetMs;            // Release time of the first job
+    uint32_t criticalSectionUs;   // Leading part of each job run holding the shared resource
+    uint16_t stackDepth;          // Stack depth in words
+    UBaseType_t criticality;
+    uint32_t wcetHiUs;            // HI-mode budget C(HI) of a HI task, 0 for none beyond the WCET
+    UBaseType_t workload;         // WORKLOAD_* kernel run for the computation
+} PeriodicTaskConfig;
+
+// A table entry resolved for the kernel and instantiated as a task. Jobs execute
+// for the exact microseconds of the table; the tick values, rounded up, feed
+// the analysis.
+typedef struct {
+    const PeriodicTaskConfig *config;
+    int taskId;
+    UBaseType_t priority;
+    TickType_t period;
+    TickType_t computation;
+    TickType_t deadline;
+    TickType_t offset;
+    TickType_t criticalSection;
+    uint32_t computationUs;
+    uint32_t computationHiUs;     // C(HI): at least computationUs for a HI task, computationUs for a LO task
+    TickType_t computationHi;
+    uint32_t criticalSectionUs;   // Clamped to computationUs
+    TaskHandle_t handle;
+} PeriodicTask;
+
+extern PeriodicTask periodicTasks[MAX_PERIODIC_TASKS];
+extern UBaseType_t periodicTaskCount;
+
+void taskSetLoad(UBaseType_t assignment);
+UBaseType_t taskSetPlaceServer(TickType_t serverPeriod);
+UBaseType_t taskSetResourceCeiling(void);
+void printTaskSet(void);
+
+#endif /* TASK_SET_H */
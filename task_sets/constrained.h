@@ -0,0 +1,10 @@
+// Constrained deadlines (D < T) and release offsets. Build with
+// PRIORITY_ASSIGNMENT=PRIORITY_DEADLINE_MONOTONIC to order by deadline.
+//
+// TASK_SET_ENTRY(name, period (ms), WCET (us), deadline (ms, 0 = period),
+//                offset (ms), critical section (us), stack depth (words), criticality,
+//                HI WCET (us, 0 = none), workload)
+TASK_SET_ENTRY("Sensor",   100, 20000,  40,  0, 10000, configMINIMAL_STACK_SIZE, CRITICALITY_HI, 30000, WORKLOAD_FIR)
+TASK_SET_ENTRY("Control",   80, 20000,  80, 10, 20000, configMINIMAL_STACK_SIZE, CRITICALITY_HI, 30000, WORKLOAD_PID)
+TASK_SET_ENTRY("Actuator", 200, 30000,  60, 20,     0, configMINIMAL_STACK_SIZE, CRITICALITY_HI, 45000, WORKLOAD_SHUFFLE)
+TASK_SET_ENTRY("Logger",   500, 50000, 500,  0, 10000, configMINIMAL_STACK_SIZE, CRITICALITY_LO,     0, WORKLOAD_CRC32)
@@ -0,0 +1,9 @@
+// Default task set: three periodic tasks that hold the shared resource for
+// their whole job.
+//
+// TASK_SET_ENTRY(name, period (ms), WCET (us), deadline (ms, 0 = period),
+//                offset (ms), critical section (us), stack depth (words), criticality,
+//                HI WCET (us, 0 = none), workload)
+TASK_SET_ENTRY("Fast",   100, 20000, 0, 0, 20000, configMINIMAL_STACK_SIZE,     CRITICALITY_LO,     0, WORKLOAD_SPIN)
+TASK_SET_ENTRY("Medium", 200, 30000, 0, 0, 30000, configMINIMAL_STACK_SIZE * 2, CRITICALITY_LO,     0, WORKLOAD_SPIN)
+TASK_SET_ENTRY("Slow",   300, 50000, 0, 0, 50000, configMINIMAL_STACK_SIZE * 4, CRITICALITY_LO,     0, WORKLOAD_SPIN)
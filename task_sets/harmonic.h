@@ -0,0 +1,11 @@
+// Harmonic periods at about 80% utilization, running the compute kernels.
+// Rate monotonic is optimal up to 100% here, so the analysis accepts the set
+// and any miss comes from jobs running past their calibrated WCET.
+//
+// TASK_SET_ENTRY(name, period (ms), WCET (us), deadline (ms, 0 = period),
+//                offset (ms), critical section (us), stack depth (words), criticality,
+//                HI WCET (us, 0 = none), workload)
+TASK_SET_ENTRY("H50",   50, 10000, 0, 0,     0, configMINIMAL_STACK_SIZE, CRITICALITY_HI, 15000, WORKLOAD_PID)
+TASK_SET_ENTRY("H100", 100, 20000, 0, 0, 10000, configMINIMAL_STACK_SIZE, CRITICALITY_HI, 30000, WORKLOAD_FIR)
+TASK_SET_ENTRY("H200", 200, 30000, 0, 0, 10000, configMINIMAL_STACK_SIZE, CRITICALITY_LO,     0, WORKLOAD_CRC32)
+TASK_SET_ENTRY("H400", 400, 80000, 0, 0,     0, configMINIMAL_STACK_SIZE, CRITICALITY_LO,     0, WORKLOAD_MATMUL)
@@ -0,0 +1,13 @@
+// A three-stage pipeline of one period for the task chains (chains/pipeline.h),
+// above a background logger, at 66% utilization. The stages share one priority
+// level. The later stages are offset so that, period-triggered, each runs
+// after the stage before it; activation-triggered, each is released by the
+// completion of the stage before it.
+//
+// TASK_SET_ENTRY(name, period (ms), WCET (us), deadline (ms, 0 = period),
+//                offset (ms), critical section (us), stack depth (words), criticality,
+//                HI WCET (us, 0 = none), workload)
+TASK_SET_ENTRY("Sample",   50,  5000, 0,  0, 0, configMINIMAL_STACK_SIZE, CRITICALITY_LO, 0, WORKLOAD_FIR)
+TASK_SET_ENTRY("Filter",   50, 10000, 0, 10, 0, configMINIMAL_STACK_SIZE, CRITICALITY_LO, 0, WORKLOAD_FIR)
+TASK_SET_ENTRY("Control",  50,  8000, 0, 20, 0, configMINIMAL_STACK_SIZE, CRITICALITY_LO, 0, WORKLOAD_PID)
+TASK_SET_ENTRY("Logger",  200, 40000, 0,  0, 0, configMINIMAL_STACK_SIZE, CRITICALITY_LO, 0, WORKLOAD_CRC32)
@@ -0,0 +1,13 @@
+// Four tasks of one period sharing one priority level, above a long batch
+// task, at 75% utilization. The four are released on the same tick, so the
+// order and length of their turns is decided by time slicing alone (see
+// TIME_SLICE_QUANTUM_US).
+//
+// TASK_SET_ENTRY(name, period (ms), WCET (us), deadline (ms, 0 = period),
+//                offset (ms), critical section (us), stack depth (words), criticality,
+//                HI WCET (us, 0 = none), workload)
+TASK_SET_ENTRY("RR1",   100, 15000, 0, 0, 0, configMINIMAL_STACK_SIZE, CRITICALITY_LO, 0, WORKLOAD_FIR)
+TASK_SET_ENTRY("RR2",   100, 15000, 0, 0, 0, configMINIMAL_STACK_SIZE, CRITICALITY_LO, 0, WORKLOAD_CRC32)
+TASK_SET_ENTRY("RR3",   100, 15000, 0, 0, 0, configMINIMAL_STACK_SIZE, CRITICALITY_LO, 0, WORKLOAD_PID)
+TASK_SET_ENTRY("RR4",   100, 15000, 0, 0, 0, configMINIMAL_STACK_SIZE, CRITICALITY_LO, 0, WORKLOAD_SPIN)
+TASK_SET_ENTRY("Batch", 400, 60000, 0, 0, 0, configMINIMAL_STACK_SIZE, CRITICALITY_LO, 0, WORKLOAD_MATMUL)
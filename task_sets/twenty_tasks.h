@@ -0,0 +1,26 @@
+// Twenty tasks with a wide spread of periods at about 45% utilization, to
+// exercise the priority assignment, the per-task reports and the EDF band.
+//
+// TASK_SET_ENTRY(name, period (ms), WCET (us), deadline (ms, 0 = period),
+//                offset (ms), critical section (us), stack depth (words), criticality,
+//                HI WCET (us, 0 = none), workload)
+TASK_SET_ENTRY("T01",  200, 20000, 0,  0, 10000, configMINIMAL_STACK_SIZE, CRITICALITY_HI, 30000, WORKLOAD_PID)
+TASK_SET_ENTRY("T02",  250, 10000, 0, 10,     0, configMINIMAL_STACK_SIZE, CRITICALITY_HI, 15000, WORKLOAD_FIR)
+TASK_SET_ENTRY("T03",  300, 20000, 0, 20,     0, configMINIMAL_STACK_SIZE, CRITICALITY_LO,     0, WORKLOAD_CRC32)
+TASK_SET_ENTRY("T04",  400, 10000, 0,  0, 10000, configMINIMAL_STACK_SIZE, CRITICALITY_HI, 15000, WORKLOAD_MATMUL)
+TASK_SET_ENTRY("T05",  500, 20000, 0, 30,     0, configMINIMAL_STACK_SIZE, CRITICALITY_LO,     0, WORKLOAD_SHUFFLE)
+TASK_SET_ENTRY("T06",  600, 10000, 0,  0,     0, configMINIMAL_STACK_SIZE, CRITICALITY_LO,     0, WORKLOAD_PID)
+TASK_SET_ENTRY("T07",  800, 20000, 0, 40, 10000, configMINIMAL_STACK_SIZE, CRITICALITY_HI, 30000, WORKLOAD_FIR)
+TASK_SET_ENTRY("T08", 1000, 10000, 0,  0,     0, configMINIMAL_STACK_SIZE, CRITICALITY_LO,     0, WORKLOAD_CRC32)
+TASK_SET_ENTRY("T09", 1000, 20000, 0, 50,     0, configMINIMAL_STACK_SIZE, CRITICALITY_LO,     0, WORKLOAD_MATMUL)
+TASK_SET_ENTRY("T10", 1200, 10000, 0,  0, 10000, configMINIMAL_STACK_SIZE, CRITICALITY_HI, 15000, WORKLOAD_SHUFFLE)
+TASK_SET_ENTRY("T11", 1500, 30000, 0, 60,     0, configMINIMAL_STACK_SIZE, CRITICALITY_LO,     0, WORKLOAD_PID)
+TASK_SET_ENTRY("T12", 1600, 10000, 0,  0,     0, configMINIMAL_STACK_SIZE, CRITICALITY_LO,     0, WORKLOAD_FIR)
+TASK_SET_ENTRY("T13", 2000, 20000, 0, 70, 10000, configMINIMAL_STACK_SIZE, CRITICALITY_LO,     0, WORKLOAD_CRC32)
+TASK_SET_ENTRY("T14", 2000, 10000, 0,  0,     0, configMINIMAL_STACK_SIZE, CRITICALITY_HI, 15000, WORKLOAD_MATMUL)
+TASK_SET_ENTRY("T15", 2400, 20000, 0, 80,     0, configMINIMAL_STACK_SIZE, CRITICALITY_LO,     0, WORKLOAD_SHUFFLE)
+TASK_SET_ENTRY("T16", 3000, 30000, 0,  0,     0, configMINIMAL_STACK_SIZE, CRITICALITY_LO,     0, WORKLOAD_PID)
+TASK_SET_ENTRY("T17", 3000, 10000, 0, 90, 10000, configMINIMAL_STACK_SIZE, CRITICALITY_LO,     0, WORKLOAD_FIR)
+TASK_SET_ENTRY("T18", 4000, 20000, 0,  0,     0, configMINIMAL_STACK_SIZE, CRITICALITY_LO,     0, WORKLOAD_CRC32)
+TASK_SET_ENTRY("T19", 4000, 40000, 0,  0,     0, configMINIMAL_STACK_SIZE, CRITICALITY_HI, 60000, WORKLOAD_MATMUL)
+TASK_SET_ENTRY("T20", 5000, 50000, 0,  0,     0, configMINIMAL_STACK_SIZE, CRITICALITY_LO,     0, WORKLOAD_SHUFFLE)
@@ -0,0 +1,6 @@
+// Preemption thresholds for task_sets/default.h, generated by tools/threshold_assign.py
+//
+// TASK_THRESHOLD(task name, name of the task whose priority is the threshold)
+TASK_THRESHOLD("Fast", "Fast")
+TASK_THRESHOLD("Medium", "Fast")
+TASK_THRESHOLD("Slow", "Fast")
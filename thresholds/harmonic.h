@@ -0,0 +1,7 @@
+// Preemption thresholds for task_sets/harmonic.h, generated by tools/threshold_assign.py
+//
+// TASK_THRESHOLD(task name, name of the task whose priority is the threshold)
+TASK_THRESHOLD("H50", "H50")
+TASK_THRESHOLD("H100", "H50")
+TASK_THRESHOLD("H200", "H50")
+TASK_THRESHOLD("H400", "H200")
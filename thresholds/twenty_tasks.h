@@ -0,0 +1,23 @@
+// Preemption thresholds for task_sets/twenty_tasks.h, generated by tools/threshold_assign.py
+//
+// TASK_THRESHOLD(task name, name of the task whose priority is the threshold)
+TASK_THRESHOLD("T01", "T01")
+TASK_THRESHOLD("T02", "T01")
+TASK_THRESHOLD("T03", "T01")
+TASK_THRESHOLD("T04", "T01")
+TASK_THRESHOLD("T05", "T01")
+TASK_THRESHOLD("T06", "T01")
+TASK_THRESHOLD("T07", "T01")
+TASK_THRESHOLD("T08", "T01")
+TASK_THRESHOLD("T09", "T01")
+TASK_THRESHOLD("T10", "T01")
+TASK_THRESHOLD("T11", "T01")
+TASK_THRESHOLD("T12", "T01")
+TASK_THRESHOLD("T13", "T01")
+TASK_THRESHOLD("T14", "T01")
+TASK_THRESHOLD("T15", "T01")
+TASK_THRESHOLD("T16", "T01")
+TASK_THRESHOLD("T17", "T01")
+TASK_THRESHOLD("T18", "T01")
+TASK_THRESHOLD("T19", "T01")
+TASK_THRESHOLD("T20", "T01")
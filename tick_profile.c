@@ -0,0 +1,123 @@
+#include "tick_profile.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "task_set.h"
+#include "hires_timer.h"
+#include "workload.h"
+#include "tiny_print.h"
+#include "CMSDK_CM3.h"
+
+#if TICK_RATE_HZ < TICK_RATE_MIN_HZ || TICK_RATE_HZ > TICK_RATE_MAX_HZ || 1000000UL % TICK_RATE_HZ != 0
+#error "TICK_RATE_HZ must lie between TICK_RATE_MIN_HZ and TICK_RATE_MAX_HZ and divide 1 MHz"
+#endif
+
+extern void xPortSysTickHandler(void);
+
+// Tick handler time in high resolution counts, from the first tick on
+static uint32_t firstTickCounts = 0;
+static volatile uint32_t tickInterrupts = 0;
+static uint64_t tickHandlerCounts = 0;
+static uint32_t tickHandlerMax = 0;
+
+// Idle sleeps on WFI, from going to sleep to the waking interrupt
+static uint32_t sleepStartCounts = 0;
+static uint32_t idleSleeps = 0;
+static uint64_t sleepCounts = 0;
+static uint32_t suppressedTicks = 0;  // Ticks the tickless idle skipped and the kernel stepped over
+
+// SysTick vector: the port's handler, timed
+void tickProfileSysTickHandler(void)
+{
+    uint32_t start = hiresNow();
+
+    xPortSysTickHandler();
+
+    uint32_t elapsed = hiresNow() - start;
+    if (tickInterrupts == 0) {
+        firstTickCounts = start;
+    }
+    tickInterrupts++;
+    tickHandlerCounts += elapsed;
+    if (elapsed > tickHandlerMax) {
+        tickHandlerMax = elapsed;
+    }
+}
+
+// configPRE_SLEEP_PROCESSING / configPOST_SLEEP_PROCESSING of the tickless
+// idle; the port calls both with interrupts disabled around its WFI
+void tickProfilePreSleep(TickType_t expectedIdleTicks)
+{
+    (void)expectedIdleTicks;
+    sleepStartCounts = hiresNow();
+}
+
+void tickProfilePostSleep(TickType_t expectedIdleTicks)
+{
+    (void)expectedIdleTicks;
+    sleepCounts += hiresNow() - sleepStartCounts;
+    idleSleeps++;
+}
+
+// traceINCREASE_TICK_COUNT: the tick count jumps after a tickless sleep
+void tickProfileStepped(TickType_t ticks)
+{
+    suppressedTicks += ticks;
+}
+
+// Called from the idle hook when there is nothing to run. With the tick
+// running, sleep on WFI until the next interrupt, at most one tick away. The
+// context switch logger shares the idle priority, so it drains its queue
+// first. WFI wakes on a pending interrupt with interrupts disabled, so the
+// handler runs only after the sleep is recorded. The tickless idle sleeps in
+// the port instead, for as many ticks as no task needs the CPU.
+void idleSleep(void)
+{
+#if configUSE_TICKLESS_IDLE == 0
+    taskYIELD();
+
+    __disable_irq();
+    uint32_t start = hiresNow();
+    __DSB();
+    __WFI();
+    sleepCounts += hiresNow() - start;
+    idleSleeps++;
+    __enable_irq();
+#endif
+}
+
+// Largest difference between a task's period and the whole ticks it is
+// released on, the error the tick resolution adds to the release grid
+static uint32_t maxPeriodRoundingUs(void)
+{
+    uint32_t maxRounding = 0;
+
+    for (UBaseType_t i = 0; i < periodicTaskCount; ++i) {
+        uint32_t periodUs = periodicTasks[i].config->periodMs * 1000UL;
+        uint32_t releasedUs = periodicTasks[i].period * US_PER_TICK;
+        uint32_t rounding = periodUs > releasedUs ? periodUs - releasedUs : releasedUs - periodUs;
+
+        if (rounding > maxRounding) {
+            maxRounding = rounding;
+        }
+    }
+    return maxRounding;
+}
+
+void printTickProfile(void)
+{
+    uint32_t elapsed = tickInterrupts ? hiresNow() - firstTickCounts : 1;
+    uint32_t ticks = tickInterrupts ? tickInterrupts : 1;
+
+    printf("\n==== Tick Profile ====\n");
+    printf("Tick Rate (Hz): %lu\n", (uint32_t)configTICK_RATE_HZ);
+    printf("Tick Period (us): %lu\n", US_PER_TICK);
+    printf("Tickless Idle: %s\n", configUSE_TICKLESS_IDLE ? "yes" : "no");
+    printf("Tick Interrupts: %lu\n", tickInterrupts);
+    printf("Mean Tick Handler (ns): %lu\n", hiresCountsToNs((uint32_t)(tickHandlerCounts / ticks)));
+    printf("Max Tick Handler (ns): %lu\n", hiresCountsToNs(tickHandlerMax));
+    printf("Tick Handler Overhead (%%): %.2f\n", (float)tickHandlerCounts * 100 / elapsed);
+    printf("Idle Sleeps: %lu\n", idleSleeps);
+    printf("Time Asleep (%%): %.2f\n", (float)sleepCounts * 100 / elapsed);
+    printf("Suppressed Ticks: %lu\n", suppressedTicks);
+    printf("Max Period Rounding (us): %lu\n", maxPeriodRoundingUs());
+}
@@ -0,0 +1,22 @@
+#ifndef TICK_PROFILE_H
+#define TICK_PROFILE_H
+
+#include "portmacro.h"  // Required for FreeRTOS types like BaseType_t, TickType_t, etc.
+
+// Cost of the kernel tick against the timing resolution it buys. SysTick is
+// routed through tickProfileSysTickHandler(), which times the port's handler
+// with the high resolution timer. The idle task sleeps on WFI: in the idle
+// hook while the tick runs, or in the port's tickless idle with
+// TICKLESS_IDLE (FreeRTOSConfig.h), where the sleep hooks below record it.
+// Included from FreeRTOSConfig.h, so only the kernel types are available.
+#define TICK_RATE_MIN_HZ             100
+#define TICK_RATE_MAX_HZ             10000
+
+void tickProfileSysTickHandler(void);
+void tickProfilePreSleep(TickType_t expectedIdleTicks);
+void tickProfilePostSleep(TickType_t expectedIdleTicks);
+void tickProfileStepped(TickType_t ticks);
+void idleSleep(void);
+void printTickProfile(void);
+
+#endif /* TICK_PROFILE_H */
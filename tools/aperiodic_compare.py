@@ -0,0 +1,126 @@
+#!/usr/bin/env python3
+"""Compare the aperiodic servers on identical arrival sequences.
+
+Every task set is built and run under QEMU once per server variant and arrival
+seed. All variants of a seed share the arrival model and ARRIVAL_SEED, so they
+serve exactly the same aperiodic jobs; only the server differs. The per-run
+aperiodic response times and periodic deadline misses go to results.csv, and
+the mean over the seeds of each variant is printed per task set, with the
+reduction of the mean aperiodic response time against the first variant.
+
+    python3 tools/aperiodic_compare.py task_sets/default.h task_sets/harmonic.h --model poisson --seeds 5
+"""
+
+import argparse
+import csv
+import os
+import queue
+import sys
+from concurrent.futures import ThreadPoolExecutor
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import qemu_run  # noqa: E402
+
+# Fixed-priority servers for the same periodic schedule, as defines for main_rms_deferred.c
+VARIANTS = {
+    'ds':    ['SCHEDULING_POLICY=POLICY_RMS', 'APERIODIC_SERVER=SERVER_DEFERRABLE'],
+    'ds-rm': ['SCHEDULING_POLICY=POLICY_RMS', 'APERIODIC_SERVER=SERVER_DEFERRABLE',
+              'SERVER_PLACEMENT=SERVER_RATE_MONOTONIC'],
+    'slack': ['SCHEDULING_POLICY=POLICY_RMS', 'APERIODIC_SERVER=SERVER_SLACK_STEALING'],
+    'dual':  ['SCHEDULING_POLICY=POLICY_DUAL_PRIORITY', 'APERIODIC_SERVER=SERVER_DEFERRABLE'],
+}
+
+MODELS = {'uniform': 'ARRIVAL_UNIFORM', 'poisson': 'ARRIVAL_POISSON', 'bursty': 'ARRIVAL_BURSTY',
+          'trace': 'ARRIVAL_TRACE'}
+
+METRICS = ['aperiodic_mean_us', 'aperiodic_p95_us', 'aperiodic_p99_us', 'aperiodic_max_us', 'misses']
+
+RESULT_FIELDS = ['set', 'variant', 'seed'] + METRICS + ['error']
+
+
+def run_one(slots, args, task_set, variant, defines):
+    """Build and run one variant on a free build slot."""
+    slot = slots.get()
+    try:
+        output_dir = os.path.join(args.out, 'build', '%s-%d' % (variant, slot))
+        image = qemu_run.build_image(task_set, defines, output_dir, args.cc, arrival_trace=args.arrival_trace)
+        lines = qemu_run.run_image(image, args.timeout, args.qemu)
+        return qemu_run.summarize(qemu_run.parse_report(lines)), ''
+    except qemu_run.RunError as error:
+        return None, str(error).splitlines()[0]
+    finally:
+        slots.put(slot)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('task_sets', nargs='+', help='task set headers')
+    parser.add_argument('--variants', default=','.join(VARIANTS),
+                        help='comma-separated subset of: ' + ', '.join(VARIANTS))
+    parser.add_argument('--model', default='uniform', choices=sorted(MODELS), help='aperiodic arrival model')
+    parser.add_argument('--arrival-trace', help='arrival_traces/ header for --model trace')
+    parser.add_argument('--seeds', type=int, default=3, help='arrival seeds per set, 1 to N')
+    parser.add_argument('-D', dest='defines', action='append', default=[],
+                        help='define added to every variant, e.g. -D ARRIVAL_MEAN_MS=40')
+    parser.add_argument('--run-ticks', type=int, default=2000, help='MAX_TICK_COUNT of every run')
+    parser.add_argument('--jobs', type=int, default=os.cpu_count() or 1, help='parallel build/run slots')
+    parser.add_argument('--cc', default='arm-none-eabi-gcc')
+    parser.add_argument('--qemu', default='qemu-system-arm')
+    parser.add_argument('--timeout', type=int, default=300, help='seconds before a run is abandoned')
+    parser.add_argument('--out', default='experiments/aperiodic_compare', help='output directory')
+    args = parser.parse_args()
+
+    variants = [variant.strip() for variant in args.variants.split(',') if variant.strip()]
+    for variant in variants:
+        if variant not in VARIANTS:
+            parser.error('unknown variant %s' % variant)
+    # A trace is the same sequence for every seed
+    seeds = [1] if args.model == 'trace' else range(1, args.seeds + 1)
+    args.out = os.path.abspath(args.out)
+    os.makedirs(args.out, exist_ok=True)
+
+    runs = [(task_set, variant, seed) for task_set in args.task_sets for seed in seeds for variant in variants]
+    slots = queue.Queue()
+    for slot in range(args.jobs):
+        slots.put(slot)
+
+    rows = []
+    with ThreadPoolExecutor(max_workers=args.jobs) as pool:
+        futures = []
+        for task_set, variant, seed in runs:
+            defines = (['ARRIVAL_MODEL=' + MODELS[args.model], 'ARRIVAL_SEED=%d' % seed,
+                        'MAX_TICK_COUNT=%d' % args.run_ticks] + VARIANTS[variant] + args.defines)
+            futures.append(pool.submit(run_one, slots, args, task_set, variant, defines))
+        for (task_set, variant, seed), future in zip(runs, futures):
+            summary, error = future.result()
+            row = {'set': os.path.basename(task_set), 'variant': variant, 'seed': seed, 'error': error}
+            if summary:
+                row.update({key: summary[key] for key in METRICS})
+            rows.append(row)
+
+    with open(os.path.join(args.out, 'results.csv'), 'w', newline='') as output:
+        writer = csv.DictWriter(output, fieldnames=RESULT_FIELDS)
+        writer.writeheader()
+        writer.writerows(rows)
+
+    print('%-18s %-6s %5s %10s %10s %10s %10s %7s %8s' % ('set', 'server', 'runs', 'mean (us)', 'p95 (us)',
+                                                          'p99 (us)', 'max (us)', 'misses', 'gain'))
+    for task_set in args.task_sets:
+        baseline = None
+        for variant in variants:
+            done = [row for row in rows if row['set'] == os.path.basename(task_set) and row['variant'] == variant
+                    and not row['error']]
+            if not done:
+                print('%-18s %-6s %5d  failed' % (os.path.basename(task_set), variant, 0))
+                continue
+            means = [sum(row[key] for row in done) / len(done) for key in METRICS]
+            # Gain is the reduction of the mean aperiodic response against the first variant
+            if baseline is None and variant == variants[0]:
+                baseline = means[0]
+            gain = '%7.1f%%' % (100.0 * (baseline - means[0]) / baseline) if baseline else '-'
+            print('%-18s %-6s %5d %10d %10d %10d %10d %7.1f %8s' % ((os.path.basename(task_set), variant, len(done))
+                                                                     + tuple(means) + (gain,)))
+
+
+if __name__ == '__main__':
+    main()
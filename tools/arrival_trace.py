@@ -0,0 +1,49 @@
+#!/usr/bin/env python3
+"""Convert a recorded arrival trace into an arrival_traces/ header for
+ARRIVAL_MODEL=ARRIVAL_TRACE.
+
+The input is a CSV file with a header row and the columns arrival_us
+(absolute arrival time) and computation_us; rows are sorted by arrival time
+and written as interarrival times. The firmware replays the trace from the
+start when it runs out.
+
+    python3 tools/arrival_trace.py recorded.csv arrival_traces/recorded.h
+    make -C build/gcc EXTRA_CFLAGS="-DARRIVAL_MODEL=ARRIVAL_TRACE" ARRIVAL_TRACE=arrival_traces/recorded.h
+"""
+
+import argparse
+import csv
+
+
+def read_trace(path):
+    with open(path, newline='') as trace:
+        rows = [(int(float(row['arrival_us'])), int(float(row['computation_us']))) for row in csv.DictReader(trace)]
+    return sorted(rows)
+
+
+def write_trace(path, rows, source):
+    previous = 0
+    with open(path, 'w') as header:
+        header.write('// Generated by tools/arrival_trace.py from %s, %d arrivals\n' % (source, len(rows)))
+        header.write('//\n')
+        header.write('// ARRIVAL_TRACE_ENTRY(delay since the previous arrival (us), computation (us))\n')
+        for arrival_us, computation_us in rows:
+            header.write('ARRIVAL_TRACE_ENTRY(%d, %d)\n' % (arrival_us - previous, computation_us))
+            previous = arrival_us
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('csv', help='trace with arrival_us and computation_us columns')
+    parser.add_argument('header', help='header to write')
+    args = parser.parse_args()
+
+    rows = read_trace(args.csv)
+    if not rows:
+        parser.error('%s holds no arrivals' % args.csv)
+    write_trace(args.header, rows, args.csv)
+    print('%s: %d arrivals over %.1f ms' % (args.header, len(rows), rows[-1][0] / 1000.0))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,61 @@
+#!/usr/bin/env python3
+"""Measure the task chains of a task set under both release semantics.
+
+The task set is built and run under QEMU once with period-triggered chains
+(every stage keeps its period and samples the latest output of the previous
+stage) and once with activation-triggered chains (each completion releases the
+next stage). The stages of every chain must share the first stage's period,
+as activation-triggered chains require. For every chain of the chains header
+the script prints the outputs, the samples lost on the way, the mean and
+maximum end-to-end latency, the maximum data age and reaction time, and the
+reaction time bound of the boot-time analysis.
+
+    python3 tools/chain_compare.py task_sets/pipeline.h chains/pipeline.h
+"""
+
+import argparse
+import os
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import qemu_run  # noqa: E402
+
+SEMANTICS = {
+    'period':     ['TASK_CHAINS=CHAIN_PERIOD_TRIGGERED'],
+    'activation': ['TASK_CHAINS=CHAIN_ACTIVATION_TRIGGERED'],
+}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('task_set', help='task set header')
+    parser.add_argument('chains', help='chains header naming tasks of the set')
+    parser.add_argument('-D', dest='defines', action='append', default=[], help='define added to both runs')
+    parser.add_argument('--run-ticks', type=int, default=2000, help='MAX_TICK_COUNT of every run')
+    parser.add_argument('--cc', default='arm-none-eabi-gcc')
+    parser.add_argument('--qemu', default='qemu-system-arm')
+    parser.add_argument('--timeout', type=int, default=300, help='seconds before a run is abandoned')
+    parser.add_argument('--out', default='experiments/chain_compare', help='build directory')
+    args = parser.parse_args()
+    args.out = os.path.abspath(args.out)
+
+    print('%-12s %-10s %-24s %7s %5s %10s %10s %10s %10s %10s' % ('chain', 'semantics', 'stages', 'outputs', 'lost',
+                                                                  'mean (us)', 'max (us)', 'age (us)',
+                                                                  'react (us)', 'bound (us)'))
+    for semantics, defines in SEMANTICS.items():
+        try:
+            image = qemu_run.build_image(args.task_set, defines + ['MAX_TICK_COUNT=%d' % args.run_ticks] + args.defines,
+                                         os.path.join(args.out, semantics), args.cc, chains=args.chains)
+            sections = qemu_run.parse_report(qemu_run.run_image(image, args.timeout, args.qemu))
+        except qemu_run.RunError as error:
+            print('%-12s %-10s  failed: %s' % ('-', semantics, str(error).splitlines()[0]))
+            continue
+        for row in qemu_run.section_rows(sections, 'Task Chains'):
+            print('%-12s %-10s %-24s %7s %5s %10s %10s %10s %10s %10s' % (
+                row['Chain'], semantics, row['Stages'], row['Fresh Outputs'], row['Lost Samples'],
+                row['Mean Latency (us)'], row['Max Latency (us)'], row['Max Data Age (us)'],
+                row['Max Reaction (us)'], row['Reaction Bound (us)']))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,83 @@
+#!/usr/bin/env python3
+"""Compare the mixed-criticality policies on the same overruns.
+
+Every task set is built and run under QEMU once per policy, with the same HI
+overrun pattern: every --overrun-every-th job of each HI task runs its HI WCET
+(HI_OVERRUN_EVERY). 'none' keeps LO mode throughout, 'drop' and 'degrade'
+switch to HI mode at the first overrun and back at the next idle instant
+(MIXED_CRITICALITY). For each run the script prints the deadline misses of the
+HI and the LO tasks, the LO jobs sacrificed, the mode switches, the mean and
+maximum switch latency and the ticks spent in HI mode.
+
+    python3 tools/criticality_compare.py task_sets/harmonic.h task_sets/twenty_tasks.h --overrun-every 5
+"""
+
+import argparse
+import os
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import qemu_run  # noqa: E402
+
+POLICIES = {
+    'none':    ['MIXED_CRITICALITY=MC_NONE'],
+    'drop':    ['MIXED_CRITICALITY=MC_DROP'],
+    'degrade': ['MIXED_CRITICALITY=MC_DEGRADE'],
+}
+
+
+def int_value(sections, key):
+    return int(qemu_run.section_value(sections, 'Mixed Criticality', key) or 0)
+
+
+def measure(sections):
+    criticality = {row['Task']: row['Criticality'] for row in qemu_run.section_rows(sections, 'Mixed Criticality')}
+    misses = {'HI': 0, 'LO': 0}
+    for row in qemu_run.section_rows(sections, 'Deadline Misses'):
+        if row['Task'] in criticality:
+            misses[criticality[row['Task']]] += int(row['Misses'])
+    return {'hi_misses': misses['HI'], 'lo_misses': misses['LO'],
+            'sacrificed': int_value(sections, 'LO Jobs Sacrificed'),
+            'switches': int_value(sections, 'Mode Switches'),
+            'mean_latency_ns': int_value(sections, 'Mean Switch Latency (ns)'),
+            'max_latency_ns': int_value(sections, 'Max Switch Latency (ns)'),
+            'hi_ticks': int_value(sections, 'Time in HI Mode (ticks)')}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('task_sets', nargs='+', help='task set headers')
+    parser.add_argument('--overrun-every', type=int, default=5, help='HI_OVERRUN_EVERY of every run')
+    parser.add_argument('-D', dest='defines', action='append', default=[], help='define added to every policy')
+    parser.add_argument('--run-ticks', type=int, default=2000, help='MAX_TICK_COUNT of every run')
+    parser.add_argument('--cc', default='arm-none-eabi-gcc')
+    parser.add_argument('--qemu', default='qemu-system-arm')
+    parser.add_argument('--timeout', type=int, default=300, help='seconds before a run is abandoned')
+    parser.add_argument('--out', default='experiments/criticality_compare', help='build directory')
+    args = parser.parse_args()
+    args.out = os.path.abspath(args.out)
+
+    common = ['SCHEDULING_POLICY=POLICY_RMS', 'APERIODIC_SERVER=SERVER_DEFERRABLE',
+              'HI_OVERRUN_EVERY=%d' % args.overrun_every, 'MAX_TICK_COUNT=%d' % args.run_ticks]
+    print('%-18s %-8s %9s %9s %10s %8s %16s %15s %8s' % ('set', 'policy', 'HI misses', 'LO misses', 'sacrificed',
+                                                         'switches', 'mean switch (ns)', 'max switch (ns)',
+                                                         'HI ticks'))
+    for task_set in args.task_sets:
+        name = os.path.basename(task_set)
+        for policy, defines in POLICIES.items():
+            try:
+                image = qemu_run.build_image(task_set, common + defines + args.defines,
+                                             os.path.join(args.out, policy), args.cc)
+                sections = qemu_run.parse_report(qemu_run.run_image(image, args.timeout, args.qemu))
+            except qemu_run.RunError as error:
+                print('%-18s %-8s  failed: %s' % (name, policy, str(error).splitlines()[0]))
+                continue
+            result = measure(sections)
+            print('%-18s %-8s %9d %9d %10d %8d %16d %15d %8d' % (name, policy, result['hi_misses'], result['lo_misses'],
+                                                                 result['sacrificed'], result['switches'],
+                                                                 result['mean_latency_ns'], result['max_latency_ns'],
+                                                                 result['hi_ticks']))
+
+
+if __name__ == '__main__':
+    main()
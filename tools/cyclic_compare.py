@@ -0,0 +1,97 @@
+#!/usr/bin/env python3
+"""Compare the cyclic executive with event-driven RMS on the same workload.
+
+Every task set is built and run under QEMU twice: once scheduled by the
+FreeRTOS kernel under POLICY_RMS, and once by the static frame schedule of
+POLICY_CYCLIC_EXECUTIVE. The RMS run has no aperiodic source
+(APERIODIC_SOURCE=SOURCE_NONE), so both execute exactly the periodic jobs of
+the table. For each run the script prints the jobs, deadline misses, frame
+overruns, dispatches and the dispatch overhead. Under RMS the overhead is the
+kernel's context switch time, PendSV entry to exit. Under the cyclic
+executive it is the frame handler's and dispatcher's time outside the jobs,
+the frame interrupt latency and the kernel dispatches into the dispatcher and
+back. The last column is the overhead per job that the cyclic executive saves.
+
+    python3 tools/cyclic_compare.py task_sets/default.h task_sets/harmonic.h
+"""
+
+import argparse
+import csv
+import os
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import qemu_run  # noqa: E402
+
+VARIANTS = {
+    'rms':    ['SCHEDULING_POLICY=POLICY_RMS', 'APERIODIC_SOURCE=SOURCE_NONE'],
+    'cyclic': ['SCHEDULING_POLICY=POLICY_CYCLIC_EXECUTIVE'],
+}
+
+
+def cyclic_task_rows(sections):
+    """Per-task CSV rows at the end of the Cyclic Executive section."""
+    body = sections.get('Cyclic Executive', [])
+    for index, line in enumerate(body):
+        if line.startswith('Task,'):
+            return list(csv.DictReader(body[index:]))
+    return []
+
+
+def int_value(sections, prefix, key):
+    return int(qemu_run.section_value(sections, prefix, key) or 0)
+
+
+def measure(sections, variant):
+    if variant == 'cyclic':
+        rows = cyclic_task_rows(sections)
+        return {'jobs': int_value(sections, 'Cyclic Executive', 'Jobs Run'),
+                'misses': sum(int(row['Misses']) for row in rows),
+                'overruns': int_value(sections, 'Cyclic Executive', 'Frame Overruns'),
+                'dispatches': int_value(sections, 'Cyclic Executive', 'Frames Run'),
+                'overhead_us': int_value(sections, 'Cyclic Executive', 'Dispatch Overhead (us)') +
+                               int_value(sections, 'Latency Overhead Report', 'Kernel Dispatch Time (us)')}
+
+    summary = qemu_run.summarize(sections)
+    return {'jobs': summary['jobs'], 'misses': summary['misses'], 'overruns': 0,
+            'dispatches': int_value(sections, 'Latency Overhead Report', 'Kernel Dispatches'),
+            'overhead_us': int_value(sections, 'Latency Overhead Report', 'Kernel Dispatch Time (us)')}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('task_sets', nargs='+', help='task set headers')
+    parser.add_argument('-D', dest='defines', action='append', default=[], help='define added to both variants')
+    parser.add_argument('--run-ticks', type=int, default=2000, help='MAX_TICK_COUNT of every run')
+    parser.add_argument('--cc', default='arm-none-eabi-gcc')
+    parser.add_argument('--qemu', default='qemu-system-arm')
+    parser.add_argument('--timeout', type=int, default=300, help='seconds before a run is abandoned')
+    parser.add_argument('--out', default='experiments/cyclic_compare', help='build directory')
+    args = parser.parse_args()
+    args.out = os.path.abspath(args.out)
+
+    print('%-18s %-7s %7s %7s %9s %11s %13s %13s' % ('set', 'mode', 'jobs', 'misses', 'overruns', 'dispatches',
+                                                     'overhead (us)', 'saved/job (ns)'))
+    for task_set in args.task_sets:
+        per_job_ns = {}
+        for variant, defines in VARIANTS.items():
+            name = os.path.basename(task_set)
+            try:
+                image = qemu_run.build_image(task_set, defines + ['MAX_TICK_COUNT=%d' % args.run_ticks] + args.defines,
+                                             os.path.join(args.out, variant), args.cc)
+                sections = qemu_run.parse_report(qemu_run.run_image(image, args.timeout, args.qemu))
+            except qemu_run.RunError as error:
+                print('%-18s %-7s  failed: %s' % (name, variant, str(error).splitlines()[0]))
+                continue
+            result = measure(sections, variant)
+            per_job_ns[variant] = 1000.0 * result['overhead_us'] / max(result['jobs'], 1)
+            saved = '-'
+            if variant == 'cyclic' and 'rms' in per_job_ns:
+                saved = '%.0f' % (per_job_ns['rms'] - per_job_ns['cyclic'])
+            print('%-18s %-7s %7d %7d %9d %11d %13d %13s' % (name, variant, result['jobs'], result['misses'],
+                                                             result['overruns'], result['dispatches'],
+                                                             result['overhead_us'], saved))
+
+
+if __name__ == '__main__':
+    main()
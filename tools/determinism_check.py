@@ -0,0 +1,97 @@
+#!/usr/bin/env python3
+"""Check that identical configurations give bit-identical runs under QEMU.
+
+Every task set is built once, with fixed arrival and workload seeds
+(ARRIVAL_SEED, WORKLOAD_SEED), and run --runs times in QEMU's
+instruction-count mode (-icount shift=--shift, sleep=off), where the guest
+clock follows the instructions executed rather than the host clock. The
+complete UART output of every run, from the boot lines and the context
+switch log to the end of the report, must hash the same, and the seed the
+firmware prints at boot must be the one requested. Otherwise the script
+prints the first line that differs and exits with status 1. With
+--no-icount the same runs are made against the host clock, which shows the
+run-to-run noise the mode removes.
+
+    python3 tools/determinism_check.py task_sets/default.h task_sets/harmonic.h --runs 3
+"""
+
+import argparse
+import hashlib
+import os
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import qemu_run  # noqa: E402
+
+
+def first_difference(reference, lines):
+    for index, (expected, actual) in enumerate(zip(reference, lines)):
+        if expected != actual:
+            return index + 1, expected, actual
+    if len(reference) != len(lines):
+        index = min(len(reference), len(lines))
+        return (index + 1, reference[index] if index < len(reference) else '<end of output>',
+                lines[index] if index < len(lines) else '<end of output>')
+    return None
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('task_sets', nargs='+', help='task set headers')
+    parser.add_argument('--runs', type=int, default=3, help='runs of every image')
+    parser.add_argument('--shift', type=int, default=4, help='-icount shift, 2^shift ns per instruction')
+    parser.add_argument('--no-icount', action='store_true', help='run against the host clock instead')
+    parser.add_argument('--seed', type=int, default=1, help='ARRIVAL_SEED and WORKLOAD_SEED of every build')
+    parser.add_argument('-D', dest='defines', action='append', default=[], help='define added to every build')
+    parser.add_argument('--run-ticks', type=int, default=1000, help='MAX_TICK_COUNT of every run')
+    parser.add_argument('--cc', default='arm-none-eabi-gcc')
+    parser.add_argument('--qemu', default='qemu-system-arm')
+    parser.add_argument('--timeout', type=int, default=300, help='seconds before a run is abandoned')
+    parser.add_argument('--out', default='experiments/determinism', help='build directory')
+    args = parser.parse_args()
+    args.out = os.path.abspath(args.out)
+    if args.seed == 0:
+        parser.error('the seed must be nonzero')
+
+    icount = None if args.no_icount else args.shift
+    defines = ['ARRIVAL_SEED=%d' % args.seed, 'WORKLOAD_SEED=%d' % args.seed,
+               'MAX_TICK_COUNT=%d' % args.run_ticks] + args.defines
+    failed = False
+    for task_set in args.task_sets:
+        name = os.path.splitext(os.path.basename(task_set))[0]
+        directory = os.path.join(args.out, '%s-%s' % (name, qemu_run.defines_tag(defines)))
+        try:
+            image = qemu_run.build_image(task_set, defines, directory, args.cc)
+            outputs = [qemu_run.run_image(image, args.timeout, args.qemu, icount=icount) for _ in range(args.runs)]
+        except qemu_run.RunError as error:
+            print('%-18s failed: %s' % (name, str(error).splitlines()[0]))
+            failed = True
+            continue
+
+        seed_line = 'Workload Seed: %d' % args.seed
+        if not any(line.strip() == seed_line for line in outputs[0]):
+            print('%-18s failed: the image does not print %r' % (name, seed_line))
+            failed = True
+            continue
+
+        digests = [hashlib.sha256('\n'.join(lines).encode()).hexdigest() for lines in outputs]
+        if len(set(digests)) == 1:
+            print('%-18s identical  %d runs, %d lines, sha256 %s' % (name, args.runs, len(outputs[0]), digests[0][:16]))
+            continue
+
+        failed = True
+        distinct = len(set(digests))
+        for run, lines in enumerate(outputs[1:], start=2):
+            difference = first_difference(outputs[0], lines)
+            if difference:
+                line, expected, actual = difference
+                print('%-18s DIFFERENT  %d distinct outputs in %d runs; run %d differs from run 1 at line %d:'
+                      % (name, distinct, args.runs, run, line))
+                print('    run 1: %s' % expected)
+                print('    run %d: %s' % (run, actual))
+                break
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == '__main__':
+    main()
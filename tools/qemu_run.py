@@ -0,0 +1,181 @@
+#!/usr/bin/env python3
+"""Build an image for one task set and configuration, run it under QEMU and
+parse the report the firmware prints over the UART.
+
+    python3 tools/qemu_run.py task_sets/harmonic.h -D SCHEDULING_POLICY=POLICY_EDF
+"""
+
+import argparse
+import csv
+import hashlib
+import os
+import re
+import subprocess
+import threading
+
+REPO_ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+BUILD_DIR = os.path.join(REPO_ROOT, 'build', 'gcc')
+
+END_MARKER = '==== End of Report ===='
+SECTION_RE = re.compile(r'^==== (.*) ====\s*$')
+
+
+class RunError(Exception):
+    pass
+
+
+def build_image(task_set, defines=(), output_dir=None, cc='arm-none-eabi-gcc', make='make', jobs=1,
+                arrival_trace=None, thresholds=None, chains=None):
+    """Build the image and return its path. Every object is rebuilt when the
+    defines differ from the last build in output_dir, so runs that alternate
+    defines are cheaper with an output_dir per set of defines."""
+    output_dir = os.path.abspath(output_dir or os.path.join(BUILD_DIR, 'output'))
+    toolchain_dir = os.path.dirname(cc)
+    size = os.path.join(toolchain_dir, 'arm-none-eabi-size') if toolchain_dir else 'arm-none-eabi-size'
+    os.makedirs(output_dir, exist_ok=True)
+
+    command = [make, '-C', BUILD_DIR, '-j%d' % jobs,
+               'CC=' + cc, 'LD=' + cc, 'SIZE=' + size,
+               'OUTPUT_DIR=' + output_dir,
+               'TASK_SET=' + os.path.abspath(task_set),
+               'EXTRA_CFLAGS=' + ' '.join('-D' + define for define in defines)]
+    if arrival_trace:
+        command.append('ARRIVAL_TRACE=' + os.path.abspath(arrival_trace))
+    if thresholds:
+        command.append('THRESHOLDS=' + os.path.abspath(thresholds))
+    if chains:
+        command.append('CHAINS=' + os.path.abspath(chains))
+    result = subprocess.run(command, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+    if result.returncode != 0:
+        raise RunError('build failed for %s:\n%s' % (task_set, result.stdout[-4000:]))
+    return os.path.join(output_dir, 'RTOSDemo.out')
+
+
+def defines_tag(defines):
+    """Short hash of a list of defines, to name an output directory per set."""
+    return hashlib.sha256(' '.join(defines).encode()).hexdigest()[:10]
+
+
+def icount_args(shift):
+    """QEMU options that tie the guest clock to the instructions executed, one
+    per 2^shift ns, instead of the host clock. Idle time is skipped rather
+    than slept (sleep=off), so the run is both fast and independent of host
+    load: identical images then print identical output."""
+    return ['-icount', 'shift=%d,align=off,sleep=off' % shift]
+
+
+def run_image(image, timeout=120, qemu='qemu-system-arm', extra_args=(), icount=None):
+    """Run the image until the end-of-report marker and return the UART output.
+    With icount set, the guest runs in deterministic instruction-count mode."""
+    command = [qemu, '-machine', 'mps2-an385', '-cpu', 'cortex-m3', '-kernel', image,
+               '-monitor', 'none', '-nographic', '-serial', 'stdio'] + list(extra_args)
+    if icount is not None:
+        command += icount_args(icount)
+    process = subprocess.Popen(command, stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                               stdin=subprocess.DEVNULL, universal_newlines=True, errors='replace')
+    timer = threading.Timer(timeout, process.kill)
+    lines = []
+    timer.start()
+    try:
+        for line in process.stdout:
+            lines.append(line.rstrip('\r\n'))
+            if line.strip() == END_MARKER:
+                break
+    finally:
+        timer.cancel()
+        process.kill()
+        process.wait()
+
+    if not lines or lines[-1].strip() != END_MARKER:
+        raise RunError('%s did not finish within %d s' % (image, timeout))
+    return lines
+
+
+def parse_report(lines):
+    """Split the output into {section title: [lines]}; later sections of the
+    same title replace earlier ones."""
+    sections = {}
+    current = None
+    for line in lines:
+        match = SECTION_RE.match(line.strip())
+        if match:
+            current = match.group(1)
+            sections[current] = []
+        elif current is not None and line.strip():
+            sections[current].append(line.strip())
+    return sections
+
+
+def is_table_line(line):
+    """A CSV line, as opposed to a 'Key: value' line that may contain commas."""
+    return ',' in line and ': ' not in line.split(',', 1)[0]
+
+
+def section_rows(sections, prefix):
+    """Rows of the CSV table in the first section whose title starts with
+    prefix, as dicts. 'Key: value' lines before the table are skipped."""
+    for title, body in sections.items():
+        if title.startswith(prefix):
+            start = next((index for index, line in enumerate(body) if is_table_line(line)), len(body))
+            end = next((index for index in range(start, len(body)) if not is_table_line(body[index])), len(body))
+            return list(csv.DictReader(body[start:end]))
+    return []
+
+
+def section_value(sections, prefix, key):
+    """Value of a 'Key: value' line in the first section whose title starts with prefix."""
+    for title, body in sections.items():
+        if title.startswith(prefix):
+            for line in body:
+                if line.startswith(key + ':'):
+                    return line.split(':', 1)[1].strip()
+    return None
+
+
+def summarize(sections):
+    """Deadline misses, periodic and aperiodic response times of a run."""
+    misses = section_rows(sections, 'Deadline Misses')
+    responses = section_rows(sections, 'Predicted vs Measured Response Times')
+    aperiodic = {row['Metric']: row for row in section_rows(sections, 'Aperiodic Response Times')}
+    response = aperiodic.get('Response Time', {})
+    queueing = aperiodic.get('Queueing Delay', {})
+    return {
+        'analysis_schedulable': section_value(sections, 'Response Time Analysis', 'Task Set Schedulable') == 'yes',
+        'jobs': sum(int(row['Jobs']) for row in misses),
+        'misses': sum(int(row['Misses']) for row in misses),
+        'max_lateness': max([int(row['Max Lateness (ticks)']) for row in misses] or [0]),
+        'max_response': {row['Task']: row['Measured Max R'] for row in responses},
+        'violations': sum(1 for row in responses if row['Status'] == 'VIOLATION'),
+        'aperiodic_mean_us': int(response.get('Mean (us)', 0)),
+        'aperiodic_p95_us': int(response.get('P95 (us)', 0)),
+        'aperiodic_p99_us': int(response.get('P99 (us)', 0)),
+        'aperiodic_max_us': int(response.get('Max (us)', 0)),
+        'queueing_p95_us': int(queueing.get('P95 (us)', 0)),
+        'preemptions': sum(int(row['Preemptions']) for row in section_rows(sections, 'Preemption Thresholds')),
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('task_set', help='task set header')
+    parser.add_argument('-D', dest='defines', action='append', default=[], help='extra define, e.g. -D MAX_TICK_COUNT=2000')
+    parser.add_argument('--output-dir', help='build output directory')
+    parser.add_argument('--arrival-trace', help='arrival trace header for -D ARRIVAL_MODEL=ARRIVAL_TRACE')
+    parser.add_argument('--cc', default='arm-none-eabi-gcc')
+    parser.add_argument('--qemu', default='qemu-system-arm')
+    parser.add_argument('--timeout', type=int, default=120, help='seconds before the run is abandoned')
+    parser.add_argument('--icount', type=int, metavar='SHIFT', help='deterministic QEMU -icount shift')
+    parser.add_argument('--raw', action='store_true', help='print the UART output')
+    args = parser.parse_args()
+
+    image = build_image(args.task_set, args.defines, args.output_dir, args.cc, arrival_trace=args.arrival_trace)
+    lines = run_image(image, args.timeout, args.qemu, icount=args.icount)
+    if args.raw:
+        print('\n'.join(lines))
+    summary = summarize(parse_report(lines))
+    for key, value in summary.items():
+        print('%s: %s' % (key, value))
+
+
+if __name__ == '__main__':
+    main()
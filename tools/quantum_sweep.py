@@ -0,0 +1,75 @@
+#!/usr/bin/env python3
+"""Sweep the round-robin quantum of the tasks of equal priority.
+
+The task set is built and run under QEMU once per quantum in --quanta, in
+microseconds (TIME_SLICE_QUANTUM_US). 0 leaves the rotation to the tick, the
+baseline; any other value has DUALTIMER2 rotate the tasks and the tick not.
+For each run the script prints the periodic jobs completed and the deadline
+misses, the quantum expiries, the rotations among equal priorities, the
+kernel dispatches and their time, and the mean and maximum response time of
+the periodic jobs in microseconds.
+
+    python3 tools/quantum_sweep.py task_sets/round_robin.h --quanta 0,500,1000,2000,5000
+"""
+
+import argparse
+import os
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import qemu_run  # noqa: E402
+
+
+def int_value(sections, prefix, key):
+    return int(qemu_run.section_value(sections, prefix, key) or 0)
+
+
+def measure(sections):
+    summary = qemu_run.summarize(sections)
+    rows = qemu_run.section_rows(sections, 'Round-Robin Quantum')
+    measured = sum(int(row['Measured Jobs']) for row in rows)
+    total_us = sum(int(row['Measured Jobs']) * int(row['Mean Response (us)']) for row in rows)
+    return {'jobs': summary['jobs'], 'misses': summary['misses'],
+            'expiries': int_value(sections, 'Round-Robin Quantum', 'Expiries'),
+            'rotations': int_value(sections, 'Round-Robin Quantum', 'Rotations'),
+            'dispatches': int_value(sections, 'Latency Overhead Report', 'Kernel Dispatches'),
+            'dispatch_us': int_value(sections, 'Latency Overhead Report', 'Kernel Dispatch Time (us)'),
+            'mean_response_us': total_us // measured if measured else 0,
+            'max_response_us': max([int(row['Max Response (us)']) for row in rows] or [0])}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('task_set', help='task set header')
+    parser.add_argument('--quanta', default='0,500,1000,2000,5000', help='comma-separated quanta in microseconds')
+    parser.add_argument('-D', dest='defines', action='append', default=[], help='define added to every run')
+    parser.add_argument('--run-ticks', type=int, default=2000, help='MAX_TICK_COUNT of every run')
+    parser.add_argument('--cc', default='arm-none-eabi-gcc')
+    parser.add_argument('--qemu', default='qemu-system-arm')
+    parser.add_argument('--timeout', type=int, default=300, help='seconds before a run is abandoned')
+    parser.add_argument('--out', default='experiments/quantum_sweep', help='build directory')
+    args = parser.parse_args()
+    args.out = os.path.abspath(args.out)
+
+    print('%-12s %7s %7s %9s %10s %11s %14s %17s %16s' % ('quantum (us)', 'jobs', 'misses', 'expiries', 'rotations',
+                                                          'dispatches', 'dispatch (us)', 'mean response (us)',
+                                                          'max response (us)'))
+    for quantum in [int(value) for value in args.quanta.split(',')]:
+        label = '%d' % quantum if quantum else 'tick'
+        try:
+            image = qemu_run.build_image(args.task_set, ['TIME_SLICE_QUANTUM_US=%d' % quantum,
+                                                         'MAX_TICK_COUNT=%d' % args.run_ticks] + args.defines,
+                                         os.path.join(args.out, label), args.cc)
+            sections = qemu_run.parse_report(qemu_run.run_image(image, args.timeout, args.qemu))
+        except qemu_run.RunError as error:
+            print('%-12s  failed: %s' % (label, str(error).splitlines()[0]))
+            continue
+        result = measure(sections)
+        print('%-12s %7d %7d %9d %10d %11d %14d %17d %16d' % (label, result['jobs'], result['misses'],
+                                                              result['expiries'], result['rotations'],
+                                                              result['dispatches'], result['dispatch_us'],
+                                                              result['mean_response_us'], result['max_response_us']))
+
+
+if __name__ == '__main__':
+    main()
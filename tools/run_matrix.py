@@ -0,0 +1,160 @@
+#!/usr/bin/env python3
+"""Build and run a matrix of configuration variants under QEMU, headless.
+
+Every combination of the axes below is built into its own output directory,
+named after the variant and a hash of its full define list, and booted in
+qemu-system-arm -machine mps2-an385 until the firmware prints the
+end-of-report marker:
+- task set (positional arguments)
+- preemption (--preemption, USE_PREEMPTION)
+- time slicing on the tick (--slicing, USE_TIME_SLICING)
+- aperiodic server (--servers): 'deferrable', 'cbs', 'slack' or 'none' for no
+  aperiodic source at all
+- tick rate (--tick-rates, TICK_RATE_HZ)
+
+Variants build and run in parallel (--jobs). Each run leaves, in its
+directory under --out, the full UART output (uart.log) and the context switch
+log the firmware streams while it runs (switch_log.csv, the format of the
+files in test_results/). The script prints a table of all runs and writes it
+to matrix.csv, with the SHA-256 of each run's UART output. With --icount the
+runs use QEMU's instruction-count mode and fixed seeds, so a variant run
+twice gives the same hash (see determinism_check.py).
+
+The defaults reproduce the eight runs of test_results/ on one task set:
+
+    python3 tools/run_matrix.py task_sets/default.h
+    python3 tools/run_matrix.py task_sets/default.h task_sets/harmonic.h --servers deferrable --tick-rates 100,1000
+"""
+
+import argparse
+import csv
+import hashlib
+import itertools
+import multiprocessing
+import os
+import re
+import sys
+import time
+from concurrent.futures import ThreadPoolExecutor
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import qemu_run  # noqa: E402
+
+SERVERS = {
+    'deferrable': ['APERIODIC_SERVER=SERVER_DEFERRABLE'],
+    'cbs':        ['APERIODIC_SERVER=SERVER_CBS', 'SCHEDULING_POLICY=POLICY_EDF'],
+    'slack':      ['APERIODIC_SERVER=SERVER_SLACK_STEALING'],
+    'none':       ['APERIODIC_SOURCE=SOURCE_NONE'],
+}
+
+SWITCH_LOG_HEADER = 'Task Name,Priority,Switched In (ticks), Switched Out (ticks), Spent In task(ticks)'
+SWITCH_LOG_RE = re.compile(r'^"[^"]*",\d+,\d+,\d+,\d+$')
+
+COLUMNS = ['variant', 'task_set', 'preemption', 'slicing', 'server', 'tick_rate', 'status', 'jobs', 'misses',
+           'max_lateness', 'switches', 'dispatch_us', 'aperiodic_mean_us', 'aperiodic_p95_us', 'tick_overhead',
+           'seconds', 'uart_sha256']
+
+
+def int_list(text):
+    return [int(value) for value in text.split(',')]
+
+
+def variants(args):
+    for task_set, preemption, slicing, server, rate in itertools.product(args.task_sets, args.preemption,
+                                                                        args.slicing, args.servers,
+                                                                        args.tick_rates):
+        name = '%s_preempt_%s_slice_%s_%s_%dhz' % (os.path.splitext(os.path.basename(task_set))[0],
+                                                   'yes' if preemption else 'no', 'yes' if slicing else 'no',
+                                                   server, rate)
+        defines = ['USE_PREEMPTION=%d' % preemption, 'USE_TIME_SLICING=%d' % slicing, 'TICK_RATE_HZ=%d' % rate,
+                   'MAX_TICK_COUNT=%d' % (args.run_ms * rate // 1000),
+                   'ARRIVAL_SEED=%d' % args.seed, 'WORKLOAD_SEED=%d' % args.seed] + SERVERS[server] + args.defines
+        yield {'variant': name, 'task_set': os.path.basename(task_set), 'path': task_set,
+               'preemption': preemption, 'slicing': slicing, 'server': server, 'tick_rate': rate,
+               'defines': defines}
+
+
+def run_variant(variant, args):
+    """Build and run one variant; returns its row of the table."""
+    # Seeds, run length and -D defines are not in the variant name, so the
+    # directory also carries a hash of the defines
+    directory = os.path.join(args.out, '%s-%s' % (variant['variant'], qemu_run.defines_tag(variant['defines'])))
+    row = {key: variant[key] for key in COLUMNS if key in variant}
+    start = time.time()
+    try:
+        image = qemu_run.build_image(variant['path'], variant['defines'], directory, args.cc)
+        lines = qemu_run.run_image(image, args.timeout, args.qemu, icount=args.icount)
+    except qemu_run.RunError as error:
+        row.update(status='failed: %s' % str(error).splitlines()[0], seconds='%.1f' % (time.time() - start))
+        return row
+
+    with open(os.path.join(directory, 'uart.log'), 'w') as log:
+        log.write('\n'.join(lines) + '\n')
+    with open(os.path.join(directory, 'switch_log.csv'), 'w') as log:
+        log.write(SWITCH_LOG_HEADER + '\n')
+        log.writelines(line + '\n' for line in lines if SWITCH_LOG_RE.match(line))
+
+    sections = qemu_run.parse_report(lines)
+    summary = qemu_run.summarize(sections)
+    row.update(status='ok', jobs=summary['jobs'], misses=summary['misses'], max_lateness=summary['max_lateness'],
+               switches=qemu_run.section_value(sections, 'Latency Overhead Report', 'Kernel Dispatches') or 0,
+               dispatch_us=qemu_run.section_value(sections, 'Latency Overhead Report', 'Kernel Dispatch Time (us)') or 0,
+               aperiodic_mean_us=summary['aperiodic_mean_us'], aperiodic_p95_us=summary['aperiodic_p95_us'],
+               tick_overhead=qemu_run.section_value(sections, 'Tick Profile', 'Tick Handler Overhead (%)') or 0,
+               seconds='%.1f' % (time.time() - start),
+               uart_sha256=hashlib.sha256('\n'.join(lines).encode()).hexdigest())
+    return row
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('task_sets', nargs='+', help='task set headers')
+    parser.add_argument('--preemption', type=int_list, default=[1, 0], help='USE_PREEMPTION values')
+    parser.add_argument('--slicing', type=int_list, default=[1, 0], help='USE_TIME_SLICING values')
+    parser.add_argument('--servers', default='deferrable,none', help='comma-separated, from %s' % ', '.join(SERVERS))
+    parser.add_argument('--tick-rates', type=int_list, default=[100], help='TICK_RATE_HZ values')
+    parser.add_argument('-D', dest='defines', action='append', default=[], help='define added to every variant')
+    parser.add_argument('--run-ms', type=int, default=10000, help='kernel time of every run')
+    parser.add_argument('--icount', type=int, metavar='SHIFT', help='deterministic QEMU -icount shift')
+    parser.add_argument('--seed', type=int, default=1, help='ARRIVAL_SEED and WORKLOAD_SEED of every variant')
+    parser.add_argument('--jobs', type=int, default=multiprocessing.cpu_count(), help='variants run at once')
+    parser.add_argument('--cc', default='arm-none-eabi-gcc')
+    parser.add_argument('--qemu', default='qemu-system-arm')
+    parser.add_argument('--timeout', type=int, default=300, help='seconds before a run is abandoned')
+    parser.add_argument('--out', default='experiments/matrix', help='directory of the runs and matrix.csv')
+    args = parser.parse_args()
+    args.out = os.path.abspath(args.out)
+    args.servers = args.servers.split(',')
+    unknown = [server for server in args.servers if server not in SERVERS]
+    if unknown:
+        parser.error('unknown server %s' % ', '.join(unknown))
+    if args.seed == 0:
+        parser.error('the seed must be nonzero')
+
+    matrix = list(variants(args))
+    start = time.time()
+    with ThreadPoolExecutor(max_workers=args.jobs) as pool:
+        rows = list(pool.map(lambda variant: run_variant(variant, args), matrix))
+
+    os.makedirs(args.out, exist_ok=True)
+    with open(os.path.join(args.out, 'matrix.csv'), 'w', newline='') as output:
+        writer = csv.DictWriter(output, fieldnames=COLUMNS, restval='')
+        writer.writeheader()
+        writer.writerows(rows)
+
+    print('%-48s %6s %6s %8s %9s %13s %11s %11s %8s' % ('variant', 'jobs', 'misses', 'lateness', 'switches',
+                                                        'dispatch (us)', 'aper. mean', 'aper. p95', 'tick (%)'))
+    for row in rows:
+        if row['status'] != 'ok':
+            print('%-48s  %s' % (row['variant'], row['status']))
+            continue
+        print('%-48s %6s %6s %8s %9s %13s %11s %11s %8s' % (row['variant'], row['jobs'], row['misses'],
+                                                            row['max_lateness'], row['switches'], row['dispatch_us'],
+                                                            row['aperiodic_mean_us'], row['aperiodic_p95_us'],
+                                                            row['tick_overhead']))
+    print('%d variants in %.0f s, results in %s' % (len(rows), time.time() - start,
+                                                     os.path.join(args.out, 'matrix.csv')))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,191 @@
+#!/usr/bin/env python3
+"""Batch schedulability experiment.
+
+For every utilization on a grid, generate task sets with UUniFast (see
+taskgen.py), build one image per set and scheduler/server variant, run each
+under QEMU and record deadline misses and response times. The results are
+reduced to schedulability-ratio-vs-utilization curves: the share of sets
+without a single measured deadline miss, next to the share accepted by the
+boot-time analysis.
+
+    python3 tools/schedulability_experiment.py --sets 20 --tasks 5 --jobs 4 --out experiments/
+
+Outputs in --out: sets/*.h, results.csv (one row per run), curves.csv and,
+if matplotlib is installed, curves.png.
+"""
+
+import argparse
+import csv
+import math
+import os
+import queue
+import random
+import sys
+from concurrent.futures import ThreadPoolExecutor
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import qemu_run  # noqa: E402
+import taskgen  # noqa: E402
+
+# Scheduler/server combinations, as defines for main_rms_deferred.c
+VARIANTS = {
+    'rms-ds':  ['SCHEDULING_POLICY=POLICY_RMS', 'APERIODIC_SERVER=SERVER_DEFERRABLE'],
+    'rms-dm-ds': ['SCHEDULING_POLICY=POLICY_RMS', 'APERIODIC_SERVER=SERVER_DEFERRABLE',
+                  'PRIORITY_ASSIGNMENT=PRIORITY_DEADLINE_MONOTONIC'],
+    'rms-slack': ['SCHEDULING_POLICY=POLICY_RMS', 'APERIODIC_SERVER=SERVER_SLACK_STEALING'],
+    'rms-dual':  ['SCHEDULING_POLICY=POLICY_DUAL_PRIORITY', 'APERIODIC_SERVER=SERVER_DEFERRABLE'],
+    'edf-ds':  ['SCHEDULING_POLICY=POLICY_EDF', 'APERIODIC_SERVER=SERVER_DEFERRABLE'],
+    'edf-cbs': ['SCHEDULING_POLICY=POLICY_EDF', 'APERIODIC_SERVER=SERVER_CBS'],
+}
+
+RESULT_FIELDS = ['set', 'variant', 'target_utilization', 'table_utilization', 'analysis_schedulable',
+                 'jobs', 'misses', 'max_lateness', 'violations', 'error']
+
+
+def utilization_grid(u_min, u_max, step):
+    points = int(math.floor((u_max - u_min) / step + 1e-9)) + 1
+    return [round(u_min + i * step, 4) for i in range(points)]
+
+
+def run_one(slots, args, task_set_path, variant, defines):
+    """Build and run one set with one variant on a free build slot."""
+    slot = slots.get()
+    try:
+        # One output directory per slot and variant, so only the task set table is recompiled
+        output_dir = os.path.join(args.out, 'build', '%s-%d' % (variant, slot))
+        image = qemu_run.build_image(task_set_path, defines, output_dir, args.cc)
+        lines = qemu_run.run_image(image, args.timeout, args.qemu)
+        return qemu_run.summarize(qemu_run.parse_report(lines)), ''
+    except qemu_run.RunError as error:
+        return None, str(error).splitlines()[0]
+    finally:
+        slots.put(slot)
+
+
+def write_curves(path, rows, step):
+    curves = {}
+    for row in rows:
+        if row['error']:
+            continue
+        point = round(round(float(row['table_utilization']) / step) * step, 4)
+        entry = curves.setdefault((row['variant'], point), [0, 0, 0])
+        entry[0] += 1
+        entry[1] += int(row['misses']) == 0
+        entry[2] += bool(row['analysis_schedulable'])
+
+    with open(path, 'w', newline='') as output:
+        writer = csv.writer(output)
+        writer.writerow(['variant', 'utilization', 'sets', 'measured_ratio', 'analysis_ratio'])
+        for (variant, point), (sets, measured, analysed) in sorted(curves.items()):
+            writer.writerow([variant, point, sets, '%.3f' % (measured / sets), '%.3f' % (analysed / sets)])
+    return curves
+
+
+def plot_curves(path, curves):
+    try:
+        import matplotlib
+        matplotlib.use('Agg')
+        import matplotlib.pyplot as plt
+    except ImportError:
+        print('matplotlib not installed, skipping %s' % path)
+        return
+
+    figure, axis = plt.subplots(figsize=(8, 5))
+    for variant in sorted({variant for variant, _ in curves}):
+        points = sorted(point for v, point in curves if v == variant)
+        measured = [curves[(variant, p)][1] / curves[(variant, p)][0] for p in points]
+        analysed = [curves[(variant, p)][2] / curves[(variant, p)][0] for p in points]
+        line, = axis.plot(points, measured, marker='o', label='%s measured' % variant)
+        axis.plot(points, analysed, linestyle='--', color=line.get_color(), label='%s analysis' % variant)
+    axis.set_xlabel('Total utilization of the task set table')
+    axis.set_ylabel('Schedulability ratio')
+    axis.set_ylim(-0.05, 1.05)
+    axis.grid(True)
+    axis.legend()
+    figure.savefig(path, dpi=120, bbox_inches='tight')
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--u-min', type=float, default=0.3)
+    parser.add_argument('--u-max', type=float, default=1.0)
+    parser.add_argument('--u-step', type=float, default=0.05)
+    parser.add_argument('--sets', type=int, default=20, help='task sets per utilization point')
+    parser.add_argument('--tasks', type=int, default=5, help='tasks per set (at most 24)')
+    parser.add_argument('--period-min', type=int, default=100, help='minimum period in ms')
+    parser.add_argument('--period-max', type=int, default=1000, help='maximum period in ms')
+    parser.add_argument('--critical-section', type=float, default=0.0,
+                        help='share of each WCET run holding the shared resource')
+    parser.add_argument('--workload', default='WORKLOAD_SPIN', choices=taskgen.WORKLOADS + ['mixed'],
+                        help="workload of every task, or 'mixed' for random compute kernels")
+    parser.add_argument('--variants', default='rms-ds,edf-ds,edf-cbs',
+                        help='comma-separated subset of: ' + ', '.join(VARIANTS))
+    parser.add_argument('-D', dest='defines', action='append', default=[],
+                        help='define added to every variant, e.g. -D CBS_BUDGET_MS=10')
+    parser.add_argument('--run-ticks', type=int, default=2000, help='MAX_TICK_COUNT of every run')
+    parser.add_argument('--seed', type=int, default=1)
+    parser.add_argument('--jobs', type=int, default=os.cpu_count() or 1, help='parallel build/run slots')
+    parser.add_argument('--cc', default='arm-none-eabi-gcc')
+    parser.add_argument('--qemu', default='qemu-system-arm')
+    parser.add_argument('--timeout', type=int, default=300, help='seconds before a run is abandoned')
+    parser.add_argument('--out', default='experiments', help='output directory')
+    args = parser.parse_args()
+
+    variants = [variant.strip() for variant in args.variants.split(',') if variant.strip()]
+    for variant in variants:
+        if variant not in VARIANTS:
+            parser.error('unknown variant %s' % variant)
+
+    args.out = os.path.abspath(args.out)
+    sets_dir = os.path.join(args.out, 'sets')
+    os.makedirs(sets_dir, exist_ok=True)
+
+    tick_hz = taskgen.tick_rate_hz(args.defines)
+    rng = random.Random(args.seed)
+    runs = []
+    for utilization in utilization_grid(args.u_min, args.u_max, args.u_step):
+        for i in range(args.sets):
+            seed = rng.randrange(1 << 30)
+            task_set = taskgen.generate_task_set(random.Random(seed), args.tasks, utilization, args.period_min,
+                                                 args.period_max, tick_hz, args.critical_section,
+                                                 workload=args.workload)
+            path = os.path.join(sets_dir, 'set_u%03d_%04d.h' % (round(utilization * 100), i))
+            taskgen.write_task_set(path, task_set, utilization, seed)
+            for variant in variants:
+                runs.append((path, utilization, taskgen.utilization_of(task_set), variant))
+
+    slots = queue.Queue()
+    for slot in range(args.jobs):
+        slots.put(slot)
+
+    common_defines = ['MAX_TICK_COUNT=%d' % args.run_ticks] + args.defines
+    rows = []
+    with ThreadPoolExecutor(max_workers=args.jobs) as pool:
+        futures = [pool.submit(run_one, slots, args, path, variant, VARIANTS[variant] + common_defines)
+                   for path, _, _, variant in runs]
+        for (path, target, table, variant), future in zip(runs, futures):
+            summary, error = future.result()
+            row = {
+                'set': os.path.basename(path),
+                'variant': variant,
+                'target_utilization': '%.3f' % target,
+                'table_utilization': '%.3f' % table,
+                'error': error,
+            }
+            if summary:
+                row.update({key: summary[key] for key in RESULT_FIELDS if key in summary})
+            rows.append(row)
+            print('%-18s %-9s U=%s misses=%s %s' % (row['set'], variant, row['table_utilization'],
+                                                    row.get('misses', '-'), error))
+
+    with open(os.path.join(args.out, 'results.csv'), 'w', newline='') as output:
+        writer = csv.DictWriter(output, fieldnames=RESULT_FIELDS)
+        writer.writeheader()
+        writer.writerows(rows)
+
+    curves = write_curves(os.path.join(args.out, 'curves.csv'), rows, args.u_step)
+    plot_curves(os.path.join(args.out, 'curves.png'), curves)
+
+
+if __name__ == '__main__':
+    main()
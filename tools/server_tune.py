@@ -0,0 +1,514 @@
+#!/usr/bin/env python3
+"""Tune the deferrable server budget and period for a task set and an
+aperiodic load.
+
+Every (budget, period) pair on a grid is tried with the server in the
+background (SERVER_PLACEMENT=SERVER_BACKGROUND, the firmware default) and at
+its rate monotonic level (SERVER_RATE_MONOTONIC). Each setting is first checked
+with the response-time analysis the firmware runs at boot, where the server is
+a periodic task with jitter T - C; every periodic task must meet its deadline.
+The settings that pass are simulated on the same arrival sequence (common
+random numbers), and the one with the lowest mean aperiodic response time wins.
+
+The simulation is fixed-priority preemptive in microseconds: periodic jobs run
+their table WCET and hold the shared resource at its ceiling (IPCP) for their
+critical section, the server budget is replenished at multiples of its period
+and a depleted server only notices the replenishment at its next poll, every
+SIMPLE_DEFERRER_SERVER_DELAY. Arrivals come from a port of arrival_model.c with
+the same generator and the same single-precision logarithm, so every model
+reproduces the firmware's sequence for the same seed.
+
+    python3 tools/server_tune.py task_sets/default.h --model poisson --mean-ms 40
+    python3 tools/server_tune.py task_sets/harmonic.h --csv tune.csv --validate
+
+With --validate the chosen pair and the firmware default are built and run
+under QEMU (see qemu_run.py), and the measured mean response time and deadline
+misses are printed next to the simulated ones.
+"""
+
+import argparse
+import collections
+import csv
+import math
+import os
+import re
+import struct
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import qemu_run  # noqa: E402
+import taskgen  # noqa: E402
+
+REPO_ROOT = taskgen.REPO_ROOT
+
+PERIODIC_LOWEST_PRIORITY = 3  # tskIDLE_PRIORITY + 3
+SERVER_PRIORITY = 2           # Background level, below every periodic task
+COMPUTATION_UNIT_US = 10000   # SIMPLE_APERIODIC_COMPUTATION_MIN/MAX unit, one 100 Hz tick
+
+ENTRY_RE = re.compile(r'^\s*TASK_SET_ENTRY\(\s*"([^"]*)"\s*,\s*(\d+)\s*,\s*(\d+)\s*,\s*(\d+)\s*,\s*(\d+)\s*,\s*(\d+)\s*,')
+TRACE_RE = re.compile(r'^\s*ARRIVAL_TRACE_ENTRY\(\s*(\d+)\s*,\s*(\d+)\s*\)')
+
+PLACEMENTS = {'background': 'SERVER_BACKGROUND', 'rate-monotonic': 'SERVER_RATE_MONOTONIC'}
+
+MODELS = {'uniform': 'ARRIVAL_UNIFORM', 'poisson': 'ARRIVAL_POISSON', 'bursty': 'ARRIVAL_BURSTY',
+          'trace': 'ARRIVAL_TRACE'}
+
+CSV_FIELDS = ['placement', 'budget_ms', 'period_ms', 'server_priority', 'schedulable', 'server_response_ticks',
+              'mean_us', 'p95_us', 'max_us', 'jobs', 'dropped', 'periodic_misses']
+
+
+def firmware_define(name, default, path='main_rms_deferred.c'):
+    """Integer value of a plain #define in a firmware source."""
+    with open(os.path.join(REPO_ROOT, path)) as source:
+        for line in source:
+            match = re.match(r'\s*#define\s+%s\s+(\d+)\b' % name, line)
+            if match:
+                return int(match.group(1))
+    return default
+
+
+def read_task_set(path):
+    """TASK_SET_ENTRY rows as dicts, times in the units of the table."""
+    tasks = []
+    with open(path) as header:
+        for line in header:
+            match = ENTRY_RE.match(line)
+            if match:
+                name, period_ms, wcet_us, deadline_ms, offset_ms, critical_section_us = match.groups()
+                tasks.append({
+                    'name': name,
+                    'period_ms': int(period_ms),
+                    'wcet_us': int(wcet_us),
+                    'deadline_ms': int(deadline_ms) or int(period_ms),
+                    'offset_ms': int(offset_ms),
+                    'critical_section_us': min(int(critical_section_us), int(wcet_us)),
+                })
+    return tasks
+
+
+def read_trace(path):
+    with open(path) as header:
+        return [(int(m.group(1)), int(m.group(2))) for m in map(TRACE_RE.match, header) if m]
+
+
+def f32(value):
+    """value rounded to single precision. One +, -, * or / of two singles in
+    double precision and then rounded is the single-precision result."""
+    return struct.unpack('f', struct.pack('f', value))[0]
+
+
+LN2_F32 = f32(0.69314718)
+SERIES_F32 = [f32(1.0 / n) for n in (3, 5, 7, 9)]
+
+
+def natural_log_f32(x):
+    """naturalLog() of arrival_model.c, rounded operation by operation as the
+    target's float arithmetic does."""
+    exponent = 0
+    while x >= 2.0:
+        x = f32(x * 0.5)
+        exponent += 1
+    while x < 1.0:
+        x = f32(x * 2.0)
+        exponent -= 1
+
+    z = f32(f32(x - 1.0) / f32(x + 1.0))
+    z2 = f32(z * z)
+    third, fifth, seventh, ninth = SERIES_F32
+    series = f32(seventh + f32(z2 * ninth))
+    series = f32(fifth + f32(z2 * series))
+    series = f32(third + f32(z2 * series))
+    series = f32(1.0 + f32(z2 * series))
+    return f32(f32(exponent * LN2_F32) + f32(f32(2.0 * z) * series))
+
+
+class ArrivalModel:
+    """Port of arrival_model.c: xorshift32 and the same draws in the same order."""
+
+    def __init__(self, model, seed, params, trace=None):
+        self.model = model
+        self.params = params
+        self.trace = trace or []
+        self.trace_index = 0
+        self.state = seed if seed != 0 else 1
+        self.in_burst = False
+        self.remaining_stay_us = self.exponential(params['calm_stay_us'])
+
+    def next_random(self):
+        x = self.state
+        x ^= (x << 13) & 0xFFFFFFFF
+        x ^= x >> 17
+        x ^= (x << 5) & 0xFFFFFFFF
+        self.state = x
+        return x
+
+    def uniform(self, low, high):
+        return low if high <= low else low + self.next_random() % (high - low + 1)
+
+    def exponential(self, mean_us):
+        u = ((self.next_random() >> 8) + 1) / 16777216.0
+        delay = f32(-natural_log_f32(u) * f32(mean_us))
+        return 0xFFFFFFFF if delay >= 4294967296.0 else int(delay)
+
+    def bursty_delay(self):
+        delay_us = 0
+        while True:
+            to_arrival = self.exponential(self.params['burst_mean_us' if self.in_burst else 'calm_mean_us'])
+            if to_arrival <= self.remaining_stay_us:
+                self.remaining_stay_us -= to_arrival
+                return delay_us + to_arrival
+            delay_us += self.remaining_stay_us
+            self.in_burst = not self.in_burst
+            self.remaining_stay_us = self.exponential(self.params['burst_stay_us' if self.in_burst else 'calm_stay_us'])
+
+    def next(self):
+        """(delay since the previous arrival, computation) in microseconds."""
+        if self.model == 'trace':
+            event = self.trace[self.trace_index]
+            self.trace_index = (self.trace_index + 1) % len(self.trace)
+            return event
+        if self.model == 'poisson':
+            delay_us = self.exponential(self.params['mean_us'])
+        elif self.model == 'bursty':
+            delay_us = self.bursty_delay()
+        else:
+            delay_us = self.uniform(self.params['delay_min_us'], self.params['delay_max_us'])
+        return delay_us, self.uniform(self.params['computation_min_us'], self.params['computation_max_us'])
+
+
+def arrival_sequence(model, horizon_us):
+    """Absolute (arrival, computation) pairs up to the horizon."""
+    arrivals = []
+    now = 0
+    while True:
+        delay_us, computation_us = model.next()
+        now += delay_us
+        if now >= horizon_us:
+            return arrivals
+        arrivals.append((now, computation_us))
+
+
+def ms_to_ticks(ms, tick_hz):
+    return ms * tick_hz // 1000
+
+
+def us_to_ticks(us, tick_hz):
+    return (us * tick_hz + 999999) // 1000000
+
+
+def assign_priorities(tasks, deadline_monotonic, server_period_ms, placement, tick_hz):
+    """Priorities of the periodic tasks and of the server, as taskSetLoad() and
+    taskSetPlaceServer() assign them."""
+    keys = [ms_to_ticks(task['deadline_ms'] if deadline_monotonic else task['period_ms'], tick_hz) for task in tasks]
+    priorities = [PERIODIC_LOWEST_PRIORITY + len({k for k in keys if k > key}) for key in keys]
+    if placement == 'background':
+        return priorities, SERVER_PRIORITY
+
+    server_key = ms_to_ticks(server_period_ms, tick_hz)
+    server_priority = PERIODIC_LOWEST_PRIORITY + len({k for k in keys if k > server_key})
+    if server_key not in keys:
+        priorities = [p + 1 if key < server_key else p for p, key in zip(priorities, keys)]
+    return priorities, server_priority
+
+
+def response_time_analysis(rta_tasks):
+    """Fixed-point analysis of response_time_analysis.c; rta_tasks are dicts
+    with C, T, D, J, CS and priority in ticks. Returns the response times, or
+    None for a task that misses its deadline."""
+    ceiling = max([task['priority'] for task in rta_tasks if task['CS'] > 0] or [0])
+    responses = []
+    for task in rta_tasks:
+        blocking = 0
+        if task['priority'] <= ceiling:
+            blocking = max([other['CS'] for other in rta_tasks if other['priority'] < task['priority']] or [0])
+        response = task['C'] + blocking
+        previous = 0
+        while response != previous and response + task['J'] <= task['D']:
+            previous = response
+            response = task['C'] + blocking + sum(
+                -(-(previous + other['J']) // other['T']) * other['C']
+                for other in rta_tasks if other is not task and other['priority'] >= task['priority'])
+        response += task['J']
+        responses.append(response if response <= task['D'] else None)
+    return responses
+
+
+def simulate(tasks, priorities, server, arrivals, horizon_us, poll_us, pool_size):
+    """Event-driven run of the periodic tasks and the deferrable server.
+    Returns the aperiodic response times, the dropped arrivals and the periodic
+    deadline misses; jobs left at three times the horizon are not counted."""
+    ceiling = max([p for task, p in zip(tasks, priorities) if task['critical_section_us'] > 0] or [0])
+    jobs = [collections.deque() for _ in tasks]   # Release times of the pending jobs
+    remaining = [0] * len(tasks)                  # Execution left of the head job
+    next_release = [task['offset_ms'] * 1000 for task in tasks]
+    queue = collections.deque()                   # [arrival, remaining computation]
+    budget = server['budget_us']
+    next_replenish = server['period_us']
+    resume_at = 0
+    responses = []
+    dropped = 0
+    misses = 0
+    arrival_index = 0
+    now = 0
+
+    def wait_for_replenishment():
+        # The depleted server blocks for one poll at a time until its period has elapsed
+        return now + -(-(next_replenish - now) // poll_us) * poll_us
+
+    while now < 3 * horizon_us:
+        for i, task in enumerate(tasks):
+            while next_release[i] <= now and next_release[i] < horizon_us:
+                if not jobs[i]:
+                    remaining[i] = task['wcet_us']
+                jobs[i].append(next_release[i])
+                next_release[i] += task['period_ms'] * 1000
+        while next_replenish <= now:
+            budget = server['budget_us']
+            next_replenish += server['period_us']
+        while arrival_index < len(arrivals) and arrivals[arrival_index][0] <= now:
+            arrival, computation = arrivals[arrival_index]
+            arrival_index += 1
+            if len(queue) >= pool_size:
+                dropped += 1
+                continue
+            queue.append([arrival, computation])
+            if budget == 0:
+                resume_at = wait_for_replenishment()
+
+        # Highest effective priority runs; ties go to the earliest ready
+        running = None
+        best = (-1, 0)
+        for i, task in enumerate(tasks):
+            if jobs[i]:
+                in_section = task['wcet_us'] - remaining[i] < task['critical_section_us']
+                candidate = (max(priorities[i], ceiling) if in_section else priorities[i], -jobs[i][0])
+                if candidate > best:
+                    running, best = i, candidate
+        if queue and budget > 0 and now >= resume_at:
+            candidate = (server['priority'], -max(queue[0][0], resume_at))
+            if candidate > best:
+                running = 'server'
+
+        pending = [r for r, j in zip(next_release, jobs) if r < horizon_us]
+        events = pending + [next_replenish]
+        if arrival_index < len(arrivals):
+            events.append(arrivals[arrival_index][0])
+        if resume_at > now:
+            events.append(resume_at)
+        if running is None and not queue and not any(jobs) and arrival_index >= len(arrivals) and not pending:
+            break
+        step = min(events) - now
+
+        if running == 'server':
+            job = queue[0]
+            step = min(step, job[1], budget)
+            job[1] -= step
+            budget -= step
+            now += step
+            if job[1] == 0:
+                responses.append(now - job[0])
+                queue.popleft()
+            if budget == 0 and queue:
+                resume_at = wait_for_replenishment()
+        elif running is not None:
+            task = tasks[running]
+            executed = task['wcet_us'] - remaining[running]
+            if executed < task['critical_section_us']:
+                step = min(step, task['critical_section_us'] - executed)
+            step = min(step, remaining[running])
+            remaining[running] -= step
+            now += step
+            if remaining[running] == 0:
+                release = jobs[running].popleft()
+                misses += now > release + task['deadline_ms'] * 1000
+                remaining[running] = task['wcet_us'] if jobs[running] else 0
+        else:
+            now += step
+    return responses, dropped, misses
+
+
+def percentile(values, fraction):
+    if not values:
+        return 0
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(math.ceil(fraction * len(ordered))) - 1)]
+
+
+def evaluate(tasks, args, budget_ms, period_ms, placement, arrival_sets, horizon_us):
+    """RTA verdict and simulated aperiodic response of one server setting."""
+    tick_hz = args.tick_hz
+    priorities, server_priority = assign_priorities(tasks, args.deadline_monotonic, period_ms, placement, tick_hz)
+    rta_tasks = [{'C': us_to_ticks(task['wcet_us'], tick_hz), 'T': ms_to_ticks(task['period_ms'], tick_hz),
+                  'D': ms_to_ticks(task['deadline_ms'], tick_hz), 'J': 0,
+                  'CS': us_to_ticks(task['critical_section_us'], tick_hz), 'priority': priority}
+                 for task, priority in zip(tasks, priorities)]
+    budget_ticks = ms_to_ticks(budget_ms, tick_hz)
+    period_ticks = ms_to_ticks(period_ms, tick_hz)
+    rta_tasks.append({'C': budget_ticks, 'T': period_ticks, 'D': period_ticks, 'J': period_ticks - budget_ticks,
+                      'CS': 0, 'priority': server_priority})
+    responses = response_time_analysis(rta_tasks)
+
+    # The server's own deadline is not a constraint, only the periodic tasks'
+    row = {'placement': placement, 'budget_ms': budget_ms, 'period_ms': period_ms,
+           'server_priority': server_priority, 'schedulable': all(r is not None for r in responses[:-1]),
+           'server_response_ticks': responses[-1] if responses[-1] is not None else '-'}
+    if not row['schedulable']:
+        return row
+
+    server = {'priority': server_priority, 'budget_us': budget_ms * 1000, 'period_us': period_ms * 1000}
+    samples, dropped, misses = [], 0, 0
+    for arrivals in arrival_sets:
+        result = simulate(tasks, priorities, server, arrivals, horizon_us, args.poll_ms * 1000, args.pool_size)
+        samples += result[0]
+        dropped += result[1]
+        misses += result[2]
+    row.update({'mean_us': int(sum(samples) / len(samples)) if samples else 0,
+                'p95_us': percentile(samples, 0.95), 'max_us': max(samples or [0]),
+                'jobs': len(samples), 'dropped': dropped, 'periodic_misses': misses})
+    return row
+
+
+def make_arrival_sets(args, trace, horizon_us):
+    params = {
+        'delay_min_us': args.delay_min_ms * 1000, 'delay_max_us': args.delay_max_ms * 1000,
+        'mean_us': args.mean_ms * 1000,
+        'calm_mean_us': firmware_define('ARRIVAL_CALM_MEAN_MS', 120) * 1000,
+        'burst_mean_us': firmware_define('ARRIVAL_BURST_MEAN_MS', 8) * 1000,
+        'calm_stay_us': firmware_define('ARRIVAL_CALM_STAY_MS', 1000) * 1000,
+        'burst_stay_us': firmware_define('ARRIVAL_BURST_STAY_MS', 60) * 1000,
+        'computation_min_us': args.computation_min_us, 'computation_max_us': args.computation_max_us,
+    }
+    return [arrival_sequence(ArrivalModel(args.model, args.seed + i, params, trace), horizon_us)
+            for i in range(args.replications)]
+
+
+def validate(args, defines, label, row, trace_path):
+    """Build and run one setting under QEMU and print it next to the simulation."""
+    # The firmware runs the aperiodic load that was tuned, not its defaults
+    load = ['APERIODIC_DELAY_MIN=%d' % args.delay_min_ms, 'APERIODIC_DELAY_MAX=%d' % args.delay_max_ms,
+            'APERIODIC_COMPUTATION_MIN_US=%d' % args.computation_min_us,
+            'APERIODIC_COMPUTATION_MAX_US=%d' % args.computation_max_us]
+    output_dir = os.path.join(args.out, 'build', label)
+    try:
+        image = qemu_run.build_image(args.task_set, load + defines, output_dir, args.cc, arrival_trace=trace_path)
+        summary = qemu_run.summarize(qemu_run.parse_report(qemu_run.run_image(image, args.timeout, args.qemu)))
+    except qemu_run.RunError as error:
+        print('%s: %s' % (label, str(error).splitlines()[0]))
+        return
+    print('%-8s %4d/%-4d ms  simulated mean %7d us, misses %d  |  measured mean %7d us, misses %d' % (
+        label, row['budget_ms'], row['period_ms'], row['mean_us'], row['periodic_misses'],
+        summary['aperiodic_mean_us'], summary['misses']))
+
+
+def main():
+    delay_min = firmware_define('APERIODIC_DELAY_MIN', 30)
+    delay_max = firmware_define('APERIODIC_DELAY_MAX', 100)
+
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('task_set', help='task set header')
+    parser.add_argument('--model', default='uniform', choices=sorted(MODELS), help='aperiodic arrival model')
+    parser.add_argument('--seed', type=int, default=firmware_define('ARRIVAL_SEED', 1))
+    parser.add_argument('--replications', type=int, default=1,
+                        help='arrival sequences simulated per setting, seeds seed, seed + 1, ...')
+    parser.add_argument('--delay-min-ms', type=int, default=delay_min, help='uniform interarrival minimum')
+    parser.add_argument('--delay-max-ms', type=int, default=delay_max, help='uniform interarrival maximum')
+    parser.add_argument('--mean-ms', type=int, default=(delay_min + delay_max) // 2, help='Poisson mean interarrival')
+    parser.add_argument('--computation-min-us', type=int, help='default SIMPLE_APERIODIC_COMPUTATION_MIN x 10 ms')
+    parser.add_argument('--computation-max-us', type=int, help='default SIMPLE_APERIODIC_COMPUTATION_MAX x 10 ms')
+    parser.add_argument('--arrival-trace', help='arrival_traces/ header for --model trace')
+    parser.add_argument('--deadline-monotonic', action='store_true', help='PRIORITY_DEADLINE_MONOTONIC task set')
+    parser.add_argument('--period-min', type=int, help='shortest server period in ms, default two ticks')
+    parser.add_argument('--period-max', type=int, default=500, help='longest server period in ms')
+    parser.add_argument('--step', type=int, help='grid step of budget and period in ms, default one tick')
+    parser.add_argument('--horizon-ms', type=int, default=60000, help='simulated time per arrival sequence')
+    parser.add_argument('--csv', help='write every evaluated setting to this file')
+    parser.add_argument('--validate', action='store_true', help='run the chosen pair and the default under QEMU')
+    parser.add_argument('--run-ticks', type=int, default=2000, help='MAX_TICK_COUNT of the validation runs')
+    parser.add_argument('-D', dest='defines', action='append', default=[], help='define added to validation builds')
+    parser.add_argument('--cc', default='arm-none-eabi-gcc')
+    parser.add_argument('--qemu', default='qemu-system-arm')
+    parser.add_argument('--timeout', type=int, default=300, help='seconds before a validation run is abandoned')
+    parser.add_argument('--out', default='experiments/server_tune', help='build directory of the validation runs')
+    args = parser.parse_args()
+
+    # The tick rate of the validation builds, TICK_RATE_HZ among the -D defines
+    tick_hz = taskgen.tick_rate_hz(args.defines)
+    tick_ms = max(1, 1000 // tick_hz)
+    if args.computation_min_us is None:
+        args.computation_min_us = firmware_define('SIMPLE_APERIODIC_COMPUTATION_MIN', 1) * COMPUTATION_UNIT_US
+    if args.computation_max_us is None:
+        args.computation_max_us = firmware_define('SIMPLE_APERIODIC_COMPUTATION_MAX', 7) * COMPUTATION_UNIT_US
+    if args.period_min is None:
+        args.period_min = 2 * tick_ms
+    if args.step is None:
+        args.step = tick_ms
+
+    args.tick_hz = tick_hz
+    args.poll_ms = firmware_define('SIMPLE_DEFERRER_SERVER_DELAY', 10)
+    args.pool_size = firmware_define('APERIODIC_POOL_SIZE', 16, 'aperiodic_job.h')
+    args.out = os.path.abspath(args.out)
+    args.step = max(tick_ms, args.step // tick_ms * tick_ms)
+
+    tasks = read_task_set(args.task_set)
+    if not tasks:
+        parser.error('%s holds no TASK_SET_ENTRY rows' % args.task_set)
+    trace = None
+    trace_path = None
+    if args.model == 'trace':
+        trace_path = args.arrival_trace or os.path.join(REPO_ROOT, 'arrival_traces', 'default.h')
+        trace = read_trace(trace_path)
+        if not trace:
+            parser.error('%s holds no ARRIVAL_TRACE_ENTRY rows' % trace_path)
+
+    arrival_sets = make_arrival_sets(args, trace, args.horizon_ms * 1000)
+    rows = []
+    for period_ms in range(max(args.step, args.period_min), args.period_max + 1, args.step):
+        for budget_ms in range(args.step, period_ms + 1, args.step):
+            for placement in PLACEMENTS:
+                rows.append(evaluate(tasks, args, budget_ms, period_ms, placement, arrival_sets,
+                                     args.horizon_ms * 1000))
+
+    if args.csv:
+        with open(args.csv, 'w', newline='') as output:
+            writer = csv.DictWriter(output, fieldnames=CSV_FIELDS, restval='')
+            writer.writeheader()
+            writer.writerows(rows)
+
+    # Settings that drop arrivals look better than they are, so they rank last
+    feasible = [row for row in rows if row['schedulable']]
+    if not feasible:
+        print('The periodic tasks are not schedulable under the analysis with any server setting')
+        sys.exit(1)
+    best = min(feasible, key=lambda row: (row['dropped'] > 0, row['mean_us'], row['budget_ms'] / row['period_ms']))
+    default = evaluate(tasks, args, firmware_define('SERVER_BUDGET_MS', 50), firmware_define('SERVER_PERIOD_MS', 100),
+                       'background', arrival_sets, args.horizon_ms * 1000)
+
+    print('%d settings, %d schedulable; %d aperiodic jobs per setting' % (len(rows), len(feasible), best['jobs']))
+    for label, row in (('default', default), ('tuned', best)):
+        print('%-8s %4d/%-4d ms  %-14s priority %2d  mean %7d us  p95 %7d us  max %7d us  dropped %d  periodic misses %d' % (
+            label, row['budget_ms'], row['period_ms'], row['placement'], row['server_priority'], row['mean_us'], row['p95_us'],
+            row['max_us'], row['dropped'], row['periodic_misses']))
+    tuned_defines = ['SERVER_PLACEMENT=' + PLACEMENTS[best['placement']], 'SERVER_BUDGET_MS=%d' % best['budget_ms'],
+                     'SERVER_PERIOD_MS=%d' % best['period_ms']]
+    print('Build with: ' + ' '.join('-D' + define for define in tuned_defines))
+
+    if args.validate:
+        # Compare over the window the firmware actually runs
+        run_args = argparse.Namespace(**vars(args))
+        run_args.replications = 1
+        run_sets = make_arrival_sets(run_args, trace, args.run_ticks * 1000 // tick_hz * 1000)
+        common = ['SCHEDULING_POLICY=POLICY_RMS', 'APERIODIC_SERVER=SERVER_DEFERRABLE',
+                  'ARRIVAL_MODEL=' + MODELS[args.model], 'ARRIVAL_SEED=%d' % args.seed,
+                  'ARRIVAL_MEAN_MS=%d' % args.mean_ms, 'MAX_TICK_COUNT=%d' % args.run_ticks]
+        if args.deadline_monotonic:
+            common.append('PRIORITY_ASSIGNMENT=PRIORITY_DEADLINE_MONOTONIC')
+        horizon_us = args.run_ticks * 1000 // tick_hz * 1000
+        print('\nValidation over %d ticks:' % args.run_ticks)
+        for label, row, defines in (('default', default, []), ('tuned', best, tuned_defines)):
+            simulated = evaluate(tasks, run_args, row['budget_ms'], row['period_ms'], row['placement'], run_sets,
+                                 horizon_us)
+            validate(args, common + defines + args.defines, label, simulated, trace_path)
+
+
+if __name__ == '__main__':
+    main()
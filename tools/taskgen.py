@@ -0,0 +1,142 @@
+#!/usr/bin/env python3
+"""Generate random periodic task sets in the task_sets/ table format.
+
+Utilizations are drawn with UUniFast (Bini & Buttazzo) so every set has the
+requested total utilization, and periods are drawn log-uniformly between a
+minimum and a maximum, rounded to whole ticks since jobs are released on the
+tick. Execution times are written in microseconds, the resolution at which the
+firmware burns them; the utilization of the written table is reported next to
+the target.
+
+    python3 tools/taskgen.py --utilization 0.7 --tasks 5 --count 10 --out-dir sets/
+"""
+
+import argparse
+import math
+import os
+import random
+import re
+
+REPO_ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+MIN_WCET_US = 100
+
+ENTRY_FORMAT = ('TASK_SET_ENTRY("{name}", {period_ms}, {wcet_us}, {deadline_ms}, {offset_ms}, '
+                '{critical_section_us}, configMINIMAL_STACK_SIZE, {criticality}, {wcet_hi_us}, {workload})\n')
+
+WORKLOADS = ['WORKLOAD_SPIN', 'WORKLOAD_CRC32', 'WORKLOAD_FIR', 'WORKLOAD_MATMUL', 'WORKLOAD_PID', 'WORKLOAD_SHUFFLE']
+
+
+def tick_rate_hz(defines=()):
+    """Tick rate of a build: TICK_RATE_HZ from the defines passed to it, or
+    else its default in FreeRTOSConfig.h."""
+    for define in defines:
+        match = re.match(r'TICK_RATE_HZ=(\d+)$', define)
+        if match:
+            return int(match.group(1))
+    with open(os.path.join(REPO_ROOT, 'FreeRTOSConfig.h')) as config:
+        for line in config:
+            match = re.match(r'\s*#define\s+TICK_RATE_HZ\s+(\d+)', line)
+            if match:
+                return int(match.group(1))
+    raise RuntimeError('TICK_RATE_HZ not found in FreeRTOSConfig.h')
+
+
+def uunifast(rng, tasks, utilization):
+    """Split utilization into per-task shares drawn uniformly from the simplex."""
+    shares = []
+    remaining = utilization
+    for i in range(1, tasks):
+        next_remaining = remaining * rng.random() ** (1.0 / (tasks - i))
+        shares.append(remaining - next_remaining)
+        remaining = next_remaining
+    shares.append(remaining)
+    return shares
+
+
+def log_uniform_period(rng, period_min_ms, period_max_ms, tick_ms):
+    """Period drawn log-uniformly and rounded to a whole number of ticks."""
+    period = math.exp(rng.uniform(math.log(period_min_ms), math.log(period_max_ms)))
+    return max(tick_ms, int(round(period / tick_ms)) * tick_ms)
+
+
+def generate_task_set(rng, tasks, utilization, period_min_ms=100, period_max_ms=1000,
+                      tick_hz=100, critical_section_fraction=0.0, hi_fraction=0.0, workload='WORKLOAD_SPIN',
+                      hi_factor=1.0):
+    """Return a list of task dicts; times are in the units of the table. A
+    workload of 'mixed' picks a random compute kernel for every task. A
+    HI-criticality task gets a HI WCET of hi_factor times its WCET."""
+    tick_ms = max(1, 1000 // tick_hz)
+    task_set = []
+
+    for index, share in enumerate(uunifast(rng, tasks, utilization)):
+        period_ms = log_uniform_period(rng, period_min_ms, period_max_ms, tick_ms)
+        wcet_us = max(MIN_WCET_US, int(round(share * period_ms * 1000)))
+        critical_section_us = int(wcet_us * critical_section_fraction)
+        hi = rng.random() < hi_fraction
+
+        task_set.append({
+            'name': 'T%02d' % (index + 1),
+            'period_ms': period_ms,
+            'wcet_us': wcet_us,
+            'deadline_ms': 0,
+            'offset_ms': 0,
+            'critical_section_us': min(critical_section_us, wcet_us),
+            'criticality': 'CRITICALITY_HI' if hi else 'CRITICALITY_LO',
+            'wcet_hi_us': int(round(wcet_us * hi_factor)) if hi and hi_factor > 1.0 else 0,
+            'workload': rng.choice(WORKLOADS[1:]) if workload == 'mixed' else workload,
+        })
+    return task_set
+
+
+def utilization_of(task_set):
+    return sum(task['wcet_us'] / (task['period_ms'] * 1000.0) for task in task_set)
+
+
+def write_task_set(path, task_set, target_utilization, seed):
+    with open(path, 'w') as header:
+        header.write('// Generated by tools/taskgen.py: UUniFast, target utilization %.3f, '
+                     'table utilization %.3f, seed %d\n' % (target_utilization, utilization_of(task_set), seed))
+        header.write('//\n')
+        header.write('// TASK_SET_ENTRY(name, period (ms), WCET (us), deadline (ms, 0 = period),\n')
+        header.write('//                offset (ms), critical section (us), stack depth (words), criticality,\n')
+        header.write('//                HI WCET (us, 0 = none), workload)\n')
+        for task in task_set:
+            header.write(ENTRY_FORMAT.format(**task))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--utilization', type=float, required=True, help='target total utilization')
+    parser.add_argument('--tasks', type=int, default=5, help='tasks per set (at most 24)')
+    parser.add_argument('--count', type=int, default=1, help='number of sets to generate')
+    parser.add_argument('--period-min', type=int, default=100, help='minimum period in ms')
+    parser.add_argument('--period-max', type=int, default=1000, help='maximum period in ms')
+    parser.add_argument('--critical-section', type=float, default=0.0,
+                        help='share of each WCET run holding the shared resource')
+    parser.add_argument('--hi-fraction', type=float, default=0.0, help='probability of a HI-criticality task')
+    parser.add_argument('--hi-factor', type=float, default=1.5, help='HI WCET of a HI-criticality task over its WCET')
+    parser.add_argument('--workload', default='WORKLOAD_SPIN', choices=WORKLOADS + ['mixed'],
+                        help="workload of every task, or 'mixed' for random compute kernels")
+    parser.add_argument('--seed', type=int, default=1)
+    parser.add_argument('--tick-hz', type=int, default=tick_rate_hz(), help='TICK_RATE_HZ the sets are built with')
+    parser.add_argument('--out-dir', default='.', help='directory for the generated headers')
+    args = parser.parse_args()
+
+    if not 1 <= args.tasks <= 24:
+        parser.error('--tasks must be between 1 and 24')
+
+    os.makedirs(args.out_dir, exist_ok=True)
+    tick_hz = args.tick_hz
+    for i in range(args.count):
+        seed = args.seed + i
+        task_set = generate_task_set(random.Random(seed), args.tasks, args.utilization, args.period_min,
+                                     args.period_max, tick_hz, args.critical_section, args.hi_fraction,
+                                     args.workload, args.hi_factor)
+        path = os.path.join(args.out_dir, 'set_u%03d_%04d.h' % (round(args.utilization * 100), i))
+        write_task_set(path, task_set, args.utilization, seed)
+        print('%s  U=%.3f' % (path, utilization_of(task_set)))
+
+
+if __name__ == '__main__':
+    main()
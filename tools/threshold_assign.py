@@ -0,0 +1,238 @@
+#!/usr/bin/env python3
+"""Assign preemption thresholds to a task set.
+
+Starting from the rate (or deadline) monotonic priorities of taskSetLoad(),
+every task, highest priority first, gets the highest threshold that keeps the
+whole set schedulable (Saksena and Wang's maximal assignment). A higher
+threshold only ever removes preemptions, so the result has the fewest
+preemptions among the schedulable assignments found this way. Schedulability is
+the response-time analysis under thresholds of response_time_analysis.c, with
+the IPCP blocking of the shared resource; the deferrable server runs below the
+periodic tasks (SERVER_PLACEMENT=SERVER_BACKGROUND) and adds nothing to it.
+
+The preemptions per hyperperiod (at most --horizon-ms) are counted by a
+simulation with the table WCETs, fully preemptive and with the thresholds. The
+thresholds are written as a header for THRESHOLD_FILE:
+
+    python3 tools/threshold_assign.py task_sets/default.h -o thresholds/default.h
+    make TASK_SET=task_sets/default.h THRESHOLDS=thresholds/default.h \\
+        EXTRA_CFLAGS="-DPREEMPTION_THRESHOLDS=THRESHOLD_TABLE"
+
+With --validate both variants are built and run under QEMU (see qemu_run.py),
+and the measured preemptions and deadline misses are printed.
+"""
+
+import argparse
+import math
+import os
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import qemu_run  # noqa: E402
+import server_tune  # noqa: E402
+import taskgen  # noqa: E402
+
+
+def analyze(tasks, thresholds):
+    """Response times in ticks under the thresholds, as analyzeThresholds() in
+    response_time_analysis.c computes them; None for a missed deadline."""
+    ceiling = max([task['priority'] for task in tasks if task['CS'] > 0] or [0])
+    responses = []
+    for i, task in enumerate(tasks):
+        blocking = 0
+        if task['priority'] <= ceiling:
+            blocking = max([other['CS'] for other in tasks if other['priority'] < task['priority']] or [0])
+        blocking = max([blocking] + [other['C'] for j, other in enumerate(tasks)
+                                     if other['priority'] < task['priority'] and thresholds[j] >= task['priority']])
+        higher = [other for j, other in enumerate(tasks) if j != i and other['priority'] >= task['priority']]
+        preempting = [other for j, other in enumerate(tasks) if j != i and (
+            other['priority'] > thresholds[i] or
+            (thresholds[i] == task['priority'] and other['priority'] == task['priority']))]
+
+        worst = 0
+        q = 0
+        while worst <= task['D']:
+            release = q * task['T']
+            start = blocking + q * task['C']
+            while True:
+                previous = start
+                start = blocking + q * task['C'] + sum((1 + previous // other['T']) * other['C'] for other in higher)
+                if start == previous or start > release + task['D']:
+                    break
+            finish = start + task['C']
+            while True:
+                previous = finish
+                finish = start + task['C'] + sum((-(-previous // other['T']) - 1 - start // other['T']) * other['C']
+                                                 for other in preempting)
+                if finish == previous or finish > release + task['D']:
+                    break
+            worst = max(worst, finish - release)
+            if finish <= release + task['T']:
+                break
+            q += 1
+        responses.append(worst if worst <= task['D'] else None)
+    return responses
+
+
+def schedulable(tasks, thresholds):
+    return all(response is not None for response in analyze(tasks, thresholds))
+
+
+def assign_thresholds(tasks):
+    """Maximal thresholds, or None if the set is not schedulable preemptively."""
+    thresholds = [task['priority'] for task in tasks]
+    if not schedulable(tasks, thresholds):
+        return None
+    levels = sorted({task['priority'] for task in tasks})
+    for i in sorted(range(len(tasks)), key=lambda index: -tasks[index]['priority']):
+        for level in levels:
+            if level <= thresholds[i]:
+                continue
+            candidate = thresholds[:i] + [level] + thresholds[i + 1:]
+            if not schedulable(tasks, candidate):
+                break
+            thresholds = candidate
+    return thresholds
+
+
+def count_preemptions(tasks, thresholds, horizon_us):
+    """Preemptions per task in a simulation in microseconds. A started job runs
+    at its threshold, raised to the resource ceiling for its critical section;
+    equal priorities do not time slice."""
+    ceiling = max([task['priority'] for task in tasks if task['cs_us'] > 0] or [0])
+    releases = [task['offset_us'] for task in tasks]
+    ready = []         # [task index, remaining us, executed us, started]
+    running = None
+    preemptions = [0] * len(tasks)
+    now = 0
+
+    def effective(job):
+        task = tasks[job[0]]
+        priority = thresholds[job[0]] if job[3] else task['priority']
+        if job[3] and job[2] < task['cs_us']:
+            priority = max(priority, ceiling)
+        return priority
+
+    while now < horizon_us:
+        for i, task in enumerate(tasks):
+            while releases[i] <= now:
+                ready.append([i, task['wcet_us'], 0, False])
+                releases[i] += task['period_us']
+
+        candidates = [job for job in ready if job is not running]
+        if candidates:
+            best = max(candidates, key=lambda job: tasks[job[0]]['priority'])
+            if running is None or tasks[best[0]]['priority'] > effective(running):
+                if running is not None:
+                    preemptions[running[0]] += 1
+                running = best
+                running[3] = True
+
+        next_release = min(releases)
+        if running is None:
+            now = next_release
+            continue
+        step = min(running[1], next_release - now)
+        task = tasks[running[0]]
+        if running[2] < task['cs_us']:
+            step = min(step, task['cs_us'] - running[2])
+        now += step
+        running[1] -= step
+        running[2] += step
+        if running[1] == 0:
+            ready.remove(running)
+            running = None
+    return preemptions
+
+
+def write_header(path, task_set, tasks, thresholds):
+    by_priority = {task['priority']: task['name'] for task in tasks}
+    lines = ['// Preemption thresholds for %s, generated by tools/threshold_assign.py' % task_set,
+             '//',
+             '// TASK_THRESHOLD(task name, name of the task whose priority is the threshold)']
+    for task, threshold in zip(tasks, thresholds):
+        lines.append('TASK_THRESHOLD("%s", "%s")' % (task['name'], by_priority[threshold]))
+    text = '\n'.join(lines) + '\n'
+    if path:
+        with open(path, 'w') as header:
+            header.write(text)
+    else:
+        sys.stdout.write(text)
+
+
+def validate(args, label, defines, thresholds_path):
+    output_dir = os.path.join(args.out, label)
+    image = qemu_run.build_image(args.task_set, defines, output_dir, args.cc, thresholds=thresholds_path)
+    summary = qemu_run.summarize(qemu_run.parse_report(qemu_run.run_image(image, args.timeout, args.qemu)))
+    print('%-16s %12d %8d %10s' % (label, summary['preemptions'], summary['misses'],
+                                   'yes' if summary['analysis_schedulable'] else 'no'))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('task_set', help='task set header')
+    parser.add_argument('-o', '--output', help='thresholds header to write, stdout if omitted')
+    parser.add_argument('--deadline-monotonic', action='store_true', help='PRIORITY_DEADLINE_MONOTONIC task set')
+    parser.add_argument('--tick-hz', type=int, default=taskgen.tick_rate_hz())
+    parser.add_argument('--horizon-ms', type=int, default=60000, help='longest simulated hyperperiod')
+    parser.add_argument('--validate', action='store_true', help='run both variants under QEMU')
+    parser.add_argument('--run-ticks', type=int, default=2000, help='MAX_TICK_COUNT of the validation runs')
+    parser.add_argument('--cc', default='arm-none-eabi-gcc')
+    parser.add_argument('--qemu', default='qemu-system-arm')
+    parser.add_argument('--timeout', type=int, default=300, help='seconds before a run is abandoned')
+    parser.add_argument('--out', default='experiments/threshold_assign', help='build directory of --validate')
+    args = parser.parse_args()
+
+    table = server_tune.read_task_set(args.task_set)
+    if not table:
+        parser.error('no TASK_SET_ENTRY rows in %s' % args.task_set)
+    priorities, _ = server_tune.assign_priorities(table, args.deadline_monotonic, 0, 'background', args.tick_hz)
+    tasks = [{'name': task['name'], 'priority': priority,
+              'C': server_tune.us_to_ticks(task['wcet_us'], args.tick_hz),
+              'T': server_tune.ms_to_ticks(task['period_ms'], args.tick_hz),
+              'D': server_tune.ms_to_ticks(task['deadline_ms'], args.tick_hz),
+              'CS': server_tune.us_to_ticks(task['critical_section_us'], args.tick_hz),
+              'wcet_us': task['wcet_us'], 'cs_us': task['critical_section_us'],
+              'period_us': task['period_ms'] * 1000, 'offset_us': task['offset_ms'] * 1000}
+             for task, priority in zip(table, priorities)]
+
+    thresholds = assign_thresholds(tasks)
+    if thresholds is None:
+        sys.exit('%s is not schedulable even fully preemptive' % args.task_set)
+
+    hyperperiod_ms = 1
+    for task in table:
+        hyperperiod_ms = hyperperiod_ms * task['period_ms'] // math.gcd(hyperperiod_ms, task['period_ms'])
+    horizon_us = (max(task['offset_ms'] for task in table) + min(hyperperiod_ms, args.horizon_ms)) * 1000
+
+    preemptive = [task['priority'] for task in tasks]
+    before = count_preemptions(tasks, preemptive, horizon_us)
+    after = count_preemptions(tasks, thresholds, horizon_us)
+    responses_before = analyze(tasks, preemptive)
+    responses_after = analyze(tasks, thresholds)
+
+    print('%-20s %8s %9s %12s %12s %12s %12s' % ('task', 'priority', 'threshold', 'R preempt', 'R threshold',
+                                                 'preempt/hp', 'thresh/hp'), file=sys.stderr)
+    for i, task in enumerate(tasks):
+        print('%-20s %8d %9d %12d %12d %12d %12d' % (task['name'], task['priority'], thresholds[i],
+                                                     responses_before[i], responses_after[i], before[i], after[i]),
+              file=sys.stderr)
+    print('Preemptions in %d ms: %d fully preemptive, %d with thresholds'
+          % (horizon_us // 1000, sum(before), sum(after)), file=sys.stderr)
+
+    write_header(args.output, args.task_set, tasks, thresholds)
+
+    if args.validate:
+        if not args.output:
+            parser.error('--validate needs --output')
+        args.out = os.path.abspath(args.out)
+        common = ['SCHEDULING_POLICY=POLICY_RMS', 'MAX_TICK_COUNT=%d' % args.run_ticks]
+        if args.deadline_monotonic:
+            common.append('PRIORITY_ASSIGNMENT=PRIORITY_DEADLINE_MONOTONIC')
+        print('%-16s %12s %8s %10s' % ('variant', 'preemptions', 'misses', 'analysis'))
+        validate(args, 'preemptive', common, None)
+        validate(args, 'thresholds', common + ['PREEMPTION_THRESHOLDS=THRESHOLD_TABLE'], args.output)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,81 @@
+#!/usr/bin/env python3
+"""Measure the tick handler overhead against the timing resolution it buys.
+
+The task set is built and run under QEMU once per tick rate in --rates
+(TICK_RATE_HZ), with the tick running through idle and, with --tickless, once
+more with the tickless idle (TICKLESS_IDLE=1). Every run lasts the same
+--run-ms of kernel time. The runs have no aperiodic source by default, so
+that only the periodic load is compared. For each run the script prints
+the tick period, the tick interrupts taken, the mean and maximum tick handler
+time, the share of the run spent in the handler and asleep, the largest
+rounding of a period to whole ticks, the deadline misses and the maximum
+response time of the periodic jobs in microseconds.
+
+    python3 tools/tick_sweep.py task_sets/harmonic.h --rates 100,1000,10000 --tickless
+"""
+
+import argparse
+import os
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import qemu_run  # noqa: E402
+
+
+def int_value(sections, key):
+    return int(qemu_run.section_value(sections, 'Tick Profile', key) or 0)
+
+
+def measure(sections):
+    summary = qemu_run.summarize(sections)
+    rows = qemu_run.section_rows(sections, 'Round-Robin Quantum')
+    return {'period_us': int_value(sections, 'Tick Period (us)'),
+            'ticks': int_value(sections, 'Tick Interrupts'),
+            'mean_ns': int_value(sections, 'Mean Tick Handler (ns)'),
+            'max_ns': int_value(sections, 'Max Tick Handler (ns)'),
+            'overhead': float(qemu_run.section_value(sections, 'Tick Profile', 'Tick Handler Overhead (%)') or 0),
+            'asleep': float(qemu_run.section_value(sections, 'Tick Profile', 'Time Asleep (%)') or 0),
+            'rounding_us': int_value(sections, 'Max Period Rounding (us)'),
+            'misses': summary['misses'],
+            'max_response_us': max([int(row['Max Response (us)']) for row in rows] or [0])}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('task_set', help='task set header')
+    parser.add_argument('--rates', default='100,250,500,1000,2000,5000,10000', help='comma-separated tick rates in Hz')
+    parser.add_argument('--tickless', action='store_true', help='also run every rate with the tickless idle')
+    parser.add_argument('-D', dest='defines', action='append', default=[], help='define added to every run')
+    parser.add_argument('--run-ms', type=int, default=20000, help='kernel time of every run')
+    parser.add_argument('--cc', default='arm-none-eabi-gcc')
+    parser.add_argument('--qemu', default='qemu-system-arm')
+    parser.add_argument('--timeout', type=int, default=300, help='seconds before a run is abandoned')
+    parser.add_argument('--out', default='experiments/tick_sweep', help='build directory')
+    args = parser.parse_args()
+    args.out = os.path.abspath(args.out)
+
+    print('%7s %-8s %11s %9s %14s %13s %13s %10s %13s %7s %16s' % ('rate', 'idle', 'period (us)', 'ticks',
+                                                                     'mean tick (ns)', 'max tick (ns)', 'overhead (%)',
+                                                                     'asleep (%)', 'rounding (us)', 'misses',
+                                                                     'max response (us)'))
+    for rate in [int(value) for value in args.rates.split(',')]:
+        for tickless in ([0, 1] if args.tickless else [0]):
+            idle = 'tickless' if tickless else 'wfi'
+            defines = ['APERIODIC_SOURCE=SOURCE_NONE', 'TICK_RATE_HZ=%d' % rate, 'TICKLESS_IDLE=%d' % tickless,
+                       'MAX_TICK_COUNT=%d' % (args.run_ms * rate // 1000)]
+            try:
+                image = qemu_run.build_image(args.task_set, defines + args.defines,
+                                             os.path.join(args.out, '%d_%s' % (rate, idle)), args.cc)
+                sections = qemu_run.parse_report(qemu_run.run_image(image, args.timeout, args.qemu))
+            except qemu_run.RunError as error:
+                print('%7d %-8s  failed: %s' % (rate, idle, str(error).splitlines()[0]))
+                continue
+            result = measure(sections)
+            print('%7d %-8s %11d %9d %14d %13d %13.2f %10.2f %13d %7d %16d' % (
+                rate, idle, result['period_us'], result['ticks'], result['mean_ns'], result['max_ns'],
+                result['overhead'], result['asleep'], result['rounding_us'], result['misses'],
+                result['max_response_us']))
+
+
+if __name__ == '__main__':
+    main()
@@ -5,6 +5,10 @@
 #include "tiny_print.h"
 #include <string.h>
 #include "timers.h"
+#include "blocking_profiler.h"
+#include "hires_timer.h"
+#include "quantum_timer.h"
+#include "preemption_threshold.h"
 
 // Global arrays for storing task information
 TaskInfo taskInfo[MAX_TASKS];  // Store task details like name, state, ID, etc.
@@ -19,28 +23,23 @@ volatile static TickType_t totalTaskExecutionTime = 0;
 volatile static TickType_t totalContextSwitchTime = 0;
 volatile static TickType_t totalInterruptTime = 0;
 
+// Kernel dispatch: high resolution time from PendSV entry to exit, the context
+// save, the scheduler's choice of the next task and the context restore. Only
+// a PendSV that switched to another task is counted.
+static uint32_t dispatchStartCounts = 0;
+static TaskHandle_t dispatchFromTask = NULL;
+static volatile uint32_t kernelDispatches = 0;
+static volatile uint64_t kernelDispatchCounts = 0;
+
 volatile TickType_t deferredServerInterruptTime = 0;
 volatile uint32_t deferredServerInterruptCount = 0;
 volatile BaseType_t deferredServerActive = pdFALSE;
 
-// Global counters
-volatile uint32_t highPriorityTaskCount = 0;
-volatile uint32_t mediumPriorityTaskCount = 0;
-volatile uint32_t lowPriorityTaskCount = 0;
-volatile uint32_t aperiodicTaskCount = 0;
-
 
 // Function to count tasks
-void classifyAndCountTask(UBaseType_t taskPriority) {
-
-    if (taskPriority == SIMPLE_HIGH_PRIORITY) {
-        highPriorityTaskCount++;
-    } else if (taskPriority == SIMPLE_MEDIUM_PRIROITY) {
-        mediumPriorityTaskCount++;
-    } else if (taskPriority == SIMPLE_LOW_PRIORITY) {
-        lowPriorityTaskCount++;
-    } else if (taskPriority == SIMPLE_APERIODIC_PRIORTY) {
-        aperiodicTaskCount++;
+void classifyAndCountTask(UBaseType_t taskId) {
+    if (taskId < MAX_TASKS) {
+        taskInfo[taskId].switchCount++;
     }
 }
 
@@ -56,12 +55,14 @@ void printLatencyOverhead(void) {
     printf("Context Switch Time: %lu ticks\n", totalContextSwitchTime);
     printf("Interrupt Time: %lu ticks\n", totalInterruptTime);
     printf("Latency Overhead: %.2f%%\n", overhead);
+    printf("Kernel Dispatches: %lu\n", kernelDispatches);
+    printf("Kernel Dispatch Time (us): %lu\n", hiresCountsToUs((uint32_t)kernelDispatchCounts));
 }
 
 // Function to print aperiodic interrupt contributions
 void printAperiodicInterruptContribution(void)
 {
-    float aperiodicInterruptPercentage = (float)deferredServerInterruptTime / totalInterruptTime * 100;
+    float aperiodicInterruptPercentage = totalInterruptTime ? (float)deferredServerInterruptTime / totalInterruptTime * 100 : 0.0f;
 
     printf("\n==== Aperiodic Interrupt Contribution ====\n");
     printf("Total Interrupt Time: %lu ticks\n", totalInterruptTime);
@@ -70,13 +71,101 @@ void printAperiodicInterruptContribution(void)
     printf("Aperiodic Interrupt Contribution: %.2f%%\n", aperiodicInterruptPercentage);
 }
 
+// Called by the periodic tasks when a job completes
+void recordJobCompletion(UBaseType_t taskIndex, TickType_t releaseTime, TickType_t completionTime) {
+    if (taskIndex < MAX_TASKS) {
+        TickType_t responseTime = completionTime - releaseTime;
+
+        taskInfo[taskIndex].jobCount++;
+        if (responseTime > taskInfo[taskIndex].maxResponseTime) {
+            taskInfo[taskIndex].maxResponseTime = responseTime;
+        }
+    }
+}
+
+TickType_t getMaxResponseTime(UBaseType_t taskIndex) {
+    return taskIndex < MAX_TASKS ? taskInfo[taskIndex].maxResponseTime : 0;
+}
+
+// Execution clock of a task in high resolution timer counts: the time it has
+// spent switched in, including the current run if it is the running task
+uint32_t getTaskExecutionCounts(UBaseType_t taskIndex) {
+    if (taskIndex >= MAX_TASKS) {
+        return 0;
+    }
+
+    const volatile TaskInfo *info = &taskInfo[taskIndex];
+    uint32_t counts, switchIn, now;
+
+    // A context switch between the reads changes execCounts, so retry until
+    // the snapshot is consistent
+    do {
+        counts = info->execCounts;
+        switchIn = info->execSwitchIn;
+        now = hiresNow();
+    } while (counts != info->execCounts);
+
+    if (taskHandles[taskIndex] != xTaskGetCurrentTaskHandle()) {
+        return counts;
+    }
+    return counts + (now - switchIn);
+}
+
+// Called by the periodic tasks when a job starts executing
+void recordJobStart(UBaseType_t taskIndex, TickType_t releaseTime, TickType_t startTime) {
+    if (taskIndex < MAX_TASKS) {
+        TickType_t startDelay = startTime - releaseTime;
+
+        taskInfo[taskIndex].releaseCount++;
+        if (startDelay < taskInfo[taskIndex].minStartDelay) {
+            taskInfo[taskIndex].minStartDelay = startDelay;
+        }
+        if (startDelay > taskInfo[taskIndex].maxStartDelay) {
+            taskInfo[taskIndex].maxStartDelay = startDelay;
+        }
+    }
+}
+
+// Called by the periodic tasks when a job completes after the next release
+void recordReleaseOverrun(UBaseType_t taskIndex, TickType_t overrun) {
+    if (taskIndex < MAX_TASKS) {
+        taskInfo[taskIndex].releaseOverruns++;
+        if (overrun > taskInfo[taskIndex].maxReleaseOverrun) {
+            taskInfo[taskIndex].maxReleaseOverrun = overrun;
+        }
+    }
+}
+
+// Function to print the start delays of the periodic jobs; the release jitter
+// is the spread between the shortest and the longest delay
+void printReleaseJitter(void)
+{
+    printf("\n==== Release Jitter ====\n");
+    printf("Task,Jobs,Min Start Delay (ticks),Max Start Delay (ticks),Release Jitter (ticks),Overruns,Max Overrun (ticks)\n");
+
+    for (UBaseType_t i = 0; i < MAX_TASKS; ++i) {
+        if (taskInfo[i].releaseCount == 0) {
+            continue;
+        }
+        printf("\"%s\",%lu,%lu,%lu,%lu,%lu,%lu\n",
+               taskInfo[i].taskName,
+               taskInfo[i].releaseCount,
+               taskInfo[i].minStartDelay,
+               taskInfo[i].maxStartDelay,
+               taskInfo[i].maxStartDelay - taskInfo[i].minStartDelay,
+               taskInfo[i].releaseOverruns,
+               taskInfo[i].maxReleaseOverrun);
+    }
+}
+
 // Function to print the task counts
 void printTaskCounts(void) {
     printf("\n========= Task Counts =========\n");
-    printf("High Priority Tasks: %u\n", highPriorityTaskCount);
-    printf("Medium Priority Tasks: %u\n", mediumPriorityTaskCount);
-    printf("Low Priority Tasks: %u\n", lowPriorityTaskCount);
-    printf("Aperiodic Tasks: %u\n", aperiodicTaskCount);
+    for (UBaseType_t i = 0; i < MAX_TASKS; ++i) {
+        if (taskHandles[i] != NULL) {
+            printf("%s Tasks: %lu\n", taskInfo[i].taskName, taskInfo[i].switchCount);
+        }
+    }
 }
 
 // Function to set task name and other info from ISR (interrupt context)
@@ -96,6 +185,16 @@ void setTaskNameFromISR(TaskHandle_t xTaskHandle, const char *taskName, int task
     }
 }
 
+// Look up the tracking index of a task; returns MAX_TASKS if it is not registered
+UBaseType_t findTaskIndex(TaskHandle_t xTaskHandle) {
+    for (UBaseType_t i = 0; i < MAX_TASKS; ++i) {
+        if (taskHandles[i] == xTaskHandle) {
+            return i;
+        }
+    }
+    return MAX_TASKS;
+}
+
 void initializeTaskTracking(void) {
     for (UBaseType_t i = 0; i < MAX_TASKS; ++i) {
         taskHandles[i] = NULL;
@@ -103,6 +202,19 @@ void initializeTaskTracking(void) {
         taskInfo[i].taskId = -1;         // Invalid task ID
         taskInfo[i].lastSwitchIn = 0;
         taskInfo[i].state = eSuspended; // Default state
+        taskInfo[i].readyTime = 0;
+        taskInfo[i].readyCounts = 0;
+        taskInfo[i].awaitingDispatch = pdFALSE;
+        taskInfo[i].jobCount = 0;
+        taskInfo[i].maxResponseTime = 0;
+        taskInfo[i].switchCount = 0;
+        taskInfo[i].releaseCount = 0;
+        taskInfo[i].minStartDelay = portMAX_DELAY;
+        taskInfo[i].maxStartDelay = 0;
+        taskInfo[i].releaseOverruns = 0;
+        taskInfo[i].maxReleaseOverrun = 0;
+        taskInfo[i].execSwitchIn = 0;
+        taskInfo[i].execCounts = 0;
     }
     // printf("Task tracking initialized.\n");
 }
@@ -112,6 +224,8 @@ void traceTaskSwitchedIn(void) {
     TaskHandle_t xTaskHandle = xTaskGetCurrentTaskHandle();
     TickType_t taskSwitchInTime = xTaskGetTickCountFromISR();
 
+    quantumSwitchedIn();
+
     if (xTaskHandle != NULL) {
 
         if (xTaskHandle == xTimerGetTimerDaemonTaskHandle()) {
@@ -120,14 +234,7 @@ void traceTaskSwitchedIn(void) {
         }
 
         // Find the task index corresponding to the current task handle
-        UBaseType_t taskIndex = MAX_TASKS;  // Default to invalid index
-
-        for (UBaseType_t i = 0; i < MAX_TASKS; ++i) {
-            if (taskHandles[i] == xTaskHandle) {
-                taskIndex = i;
-                break;
-            }
-        }
+        UBaseType_t taskIndex = findTaskIndex(xTaskHandle);
 
         // If a valid task index was found, proceed with logging
         if (taskIndex < MAX_TASKS) {
@@ -137,16 +244,36 @@ void traceTaskSwitchedIn(void) {
             }
 
             taskInfo[taskIndex].lastSwitchIn = taskSwitchInTime; // Update last switch-in time
+            taskInfo[taskIndex].execSwitchIn = hiresNow();
+            taskInfo[taskIndex].awaitingDispatch = pdFALSE;
          }
     }
 }
 
-// Trace function called when a task is switched out
-void traceTaskSwitchedOut(void) {
+// Trace function called when the kernel moves a task into the ready list
+// (released from a delay, unblocked, or resumed). vTaskPrioritySet(NULL, ...)
+// also re-adds the running task to the ready list; that is not a wake-up, and
+// marking it would leave awaitingDispatch set through the task's next sleep.
+void traceTaskMovedToReady(TaskHandle_t xTaskHandle) {
+    if (xTaskHandle == xTaskGetCurrentTaskHandle()) {
+        return;
+    }
+
+    UBaseType_t taskIndex = findTaskIndex(xTaskHandle);
+
+    if (taskIndex < MAX_TASKS && !taskInfo[taskIndex].awaitingDispatch) {
+        taskInfo[taskIndex].readyTime = xTaskGetTickCountFromISR();
+        taskInfo[taskIndex].readyCounts = hiresNow();
+        taskInfo[taskIndex].awaitingDispatch = pdTRUE;
+    }
+}
+
+// Trace function called when a task is switched out; stillReady is pdTRUE when
+// it was preempted rather than blocked
+void traceTaskSwitchedOut(BaseType_t stillReady) {
     TaskHandle_t xTaskHandle = xTaskGetCurrentTaskHandle();
     TickType_t taskSwitchOutTime = xTaskGetTickCountFromISR();
 
-
     if (xTaskHandle != NULL) {
 
         if (xTaskHandle == xTimerGetTimerDaemonTaskHandle()) {
@@ -154,24 +281,21 @@ void traceTaskSwitchedOut(void) {
             return;
         }
         // Find the task index corresponding to the current task handle
-        UBaseType_t taskIndex = MAX_TASKS;  // Default to invalid index
-
-        for (UBaseType_t i = 0; i < MAX_TASKS; ++i) {
-            if (taskHandles[i] == xTaskHandle) {
-                taskIndex = i;
-                break;
-            }
-        }
+        UBaseType_t taskIndex = findTaskIndex(xTaskHandle);
 
         // If a valid task index was found, proceed with logging
         if (taskIndex < MAX_TASKS) {
             // Calculate latency (time spent in task)
             TickType_t timeSpentInTask = taskSwitchOutTime - taskInfo[taskIndex].lastSwitchIn;
+            uint32_t sliceCounts = hiresNow() - taskInfo[taskIndex].execSwitchIn;
+            taskInfo[taskIndex].execCounts += sliceCounts;
             totalContextSwitchTime += timeSpentInTask; // Approximate context switch time
             taskInfo[taskIndex].state = eBlocked;  // Assuming the task is blocked after switching out
 
             UBaseType_t taskPriority = uxTaskPriorityGetFromISR(xTaskHandle);
-            classifyAndCountTask(taskPriority);
+            classifyAndCountTask(taskIndex);
+            thresholdSwitchedOut(taskIndex, stillReady);
+            profilerOnTaskRan(taskIndex, taskPriority, taskInfo[taskIndex].lastSwitchIn, sliceCounts);
 
             // Create a log message for task switched out with latency info
             LogMessage logMessage = {
@@ -197,10 +321,11 @@ void myTraceISR_ENTER(void)
     TickType_t startInterruptTime = xTaskGetTickCountFromISR();
     totalInterruptTime -= startInterruptTime;
 
-    // Check if the deferred server is running
+    // Interrupts taken while an aperiodic server is serving a job
     if (deferredServerActive)
     {
         deferredServerInterruptTime -= startInterruptTime;
+        deferredServerInterruptCount++;
     }
 }
 
@@ -215,3 +340,34 @@ void myTraceISR_EXIT(void)
         deferredServerInterruptTime += endInterruptTime;
     }
 }
+
+static __attribute__((used)) void dispatchTimerStart(void)
+{
+    dispatchStartCounts = hiresNow();
+    dispatchFromTask = xTaskGetCurrentTaskHandle();
+}
+
+static __attribute__((used)) void dispatchTimerStop(void)
+{
+    uint32_t elapsed = hiresNow() - dispatchStartCounts;
+
+    if (xTaskGetCurrentTaskHandle() != dispatchFromTask) {
+        kernelDispatches++;
+        kernelDispatchCounts += elapsed;
+    }
+}
+
+// PendSV vector: the port's context switch, timed. The port handler ends with
+// bx lr, so it is called rather than branched to, with EXC_RETURN kept on the
+// main stack. On the way out r4-r11 hold the switched-in task's registers;
+// dispatchTimerStop() preserves them like any C function.
+__attribute__((naked)) void dispatchPendSVHandler(void)
+{
+    __asm volatile (
+        "   push {r3, lr}               \n"
+        "   bl dispatchTimerStart       \n"
+        "   bl xPortPendSVHandler       \n"
+        "   bl dispatchTimerStop        \n"
+        "   pop {r3, pc}                \n"
+    );
+}
@@ -3,13 +3,27 @@
 
 #include "portmacro.h"  // Required for FreeRTOS types like BaseType_t, TickType_t, etc.
 
-#define MAX_TASKS 10
+#define MAX_PERIODIC_TASKS 24
+#define MAX_TASKS ( MAX_PERIODIC_TASKS + 2 )
 #define MAX_TASK_NAME_LENGTH 100  // Define a reasonable maximum length
 
-#define SIMPLE_LOW_PRIORITY                ( tskIDLE_PRIORITY + 3 )
-#define SIMPLE_MEDIUM_PRIROITY             ( tskIDLE_PRIORITY + 4 )
-#define SIMPLE_HIGH_PRIORITY               ( tskIDLE_PRIORITY + 5 )
-#define SIMPLE_APERIODIC_PRIORTY           ( tskIDLE_PRIORITY + 1 )
+// The periodic tasks of the task set table get distinct priorities from the
+// band [PERIODIC_LOWEST_PRIORITY, PERIODIC_HIGHEST_PRIORITY]
+#define SERVER_PRIORITY                    ( tskIDLE_PRIORITY + 2 )
+#define PERIODIC_LOWEST_PRIORITY           ( tskIDLE_PRIORITY + 3 )
+#define PERIODIC_HIGHEST_PRIORITY          ( PERIODIC_LOWEST_PRIORITY + MAX_PERIODIC_TASKS - 1 )
+// Above every periodic task and server, so that the producer task releases
+// each aperiodic event on its arrival tick whatever the load (the baseline ran
+// it at tskIDLE_PRIORITY + 1, where periodic jobs delayed the arrivals)
+#define SIMPLE_APERIODIC_PRIORTY           ( configMAX_PRIORITIES - 2 )
+#define SLACK_SERVER_PRIORITY              ( configMAX_PRIORITIES - 3 )  // Above the periodic band
+
+// Task ids used with setTaskNameFromISR; counts are kept per id because the
+// EDF dispatcher reassigns priorities at run time. Entry i of the task set
+// table is tracked as PERIODIC_TASK_ID(i).
+#define APERIODIC_TASK_ID                  0
+#define PERIODIC_TASK_ID(index)            ( ( int ) ( index ) + 1 )
+#define SERVER_TASK_ID                     ( MAX_TASKS - 1 )
 
 // Forward declarations of FreeRTOS types
 typedef struct tskTaskControlBlock * TaskHandle_t;  // TaskHandle_t is a pointer to tskTaskControlBlock
@@ -22,6 +36,19 @@ typedef struct {
     TickType_t lastSwitchIn;
     UBaseType_t state;  // Example: store the task state
     TickType_t stackHighWaterMark; // Store stack high watermark
+    TickType_t readyTime;          // Tick at which the task last became ready
+    uint32_t readyCounts;          // High resolution time at which it became ready
+    BaseType_t awaitingDispatch;   // Ready since readyTime but not yet switched in
+    uint32_t jobCount;             // Completed periodic jobs
+    TickType_t maxResponseTime;    // Longest release-to-completion time of a job
+    uint32_t switchCount;          // Times the task was switched out
+    uint32_t releaseCount;         // Periodic jobs started
+    TickType_t minStartDelay;      // Shortest nominal-release-to-start delay of a job
+    TickType_t maxStartDelay;      // Longest nominal-release-to-start delay of a job
+    uint32_t releaseOverruns;      // Releases that passed while the previous job was still running
+    TickType_t maxReleaseOverrun;  // Longest such overrun
+    uint32_t execSwitchIn;         // High resolution time of the last switch-in
+    uint32_t execCounts;           // High resolution time spent running, up to the last switch-out
 } TaskInfo;
 
 // Define a structure to store log message details
@@ -41,8 +68,20 @@ extern QueueHandle_t logContextSwitchQueue;
 // Declare the task-related functions (we'll define them in trace_task_switch.c)
 void setTaskNameFromISR(TaskHandle_t xTaskHandle, const char *taskName, int taskId);
 void initializeTaskTracking(void);
+UBaseType_t findTaskIndex(TaskHandle_t xTaskHandle);
+void traceTaskMovedToReady(TaskHandle_t xTaskHandle);
+void traceTaskSwitchedIn(void);
+void traceTaskSwitchedOut(BaseType_t stillReady);
+void dispatchPendSVHandler(void);
 void printLatencyOverhead(void);
 void printTaskCounts(void);
+void printAperiodicInterruptContribution(void);
+void recordJobCompletion(UBaseType_t taskIndex, TickType_t releaseTime, TickType_t completionTime);
+TickType_t getMaxResponseTime(UBaseType_t taskIndex);
+void recordJobStart(UBaseType_t taskIndex, TickType_t releaseTime, TickType_t startTime);
+void recordReleaseOverrun(UBaseType_t taskIndex, TickType_t overrun);
+void printReleaseJitter(void);
+uint32_t getTaskExecutionCounts(UBaseType_t taskIndex);
 
 // Declare an array to store task information (for latency and other data)
 extern TaskInfo taskInfo[MAX_TASKS];
@@ -50,9 +89,13 @@ extern TaskHandle_t taskHandles[MAX_TASKS];  // Array to store task handles
 
 // Macros for task switching trace functions
 #define traceTASK_SWITCHED_IN()  traceTaskSwitchedIn()
-#define traceTASK_SWITCHED_OUT() traceTaskSwitchedOut()
+// Expanded in tasks.c, where the ready lists and the running TCB are in scope:
+// the task switched out is still ready when it was preempted or yielded, and
+// no longer when it blocked
+#define traceTASK_SWITCHED_OUT() traceTaskSwitchedOut( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ pxCurrentTCB->uxPriority ] ), &( pxCurrentTCB->xStateListItem ) ) )
 #define traceISR_ENTER()         myTraceISR_ENTER()
 #define traceISR_EXIT()          myTraceISR_EXIT()
+#define traceMOVED_TASK_TO_READY_STATE( pxTCB ) traceTaskMovedToReady( ( TaskHandle_t ) ( pxTCB ) )
 
 extern TaskHandle_t serverTaskHandle;
 extern volatile TickType_t deferredServerInterruptTime;
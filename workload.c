@@ -0,0 +1,97 @@
+#include "workload.h"
+#include "workload_kernels.h"
+#include "hires_timer.h"
+#include "trace_task_switch.h"
+#include "tiny_print.h"
+#include <task.h>
+
+#define WORKLOAD_CALIBRATION_ITERATIONS 200  // Kernel iterations timed at boot
+
+typedef void (*WorkloadKernel)(void);
+
+static const WorkloadKernel workloadKernels[WORKLOAD_COUNT] = {
+    NULL, kernelCrc32, kernelFir, kernelMatmul, kernelPid, kernelShuffle
+};
+
+static const char *const workloadNames[WORKLOAD_COUNT] = {
+    "Spin", "CRC32", "FIR", "MatMul", "PID", "Shuffle"
+};
+
+// High resolution timer counts per kernel iteration, scaled by 256
+static uint32_t countsPerIteration[WORKLOAD_COUNT];
+
+// Spin until the calling task has itself executed for the given time. The
+// task's execution clock only advances while it is switched in, so preemption
+// stretches the wall-clock duration but not the amount of work. Interrupts
+// taken while the task runs are charged to it, as they would be on hardware.
+void burnExecutionTime(uint32_t microseconds)
+{
+    UBaseType_t taskIndex = findTaskIndex(xTaskGetCurrentTaskHandle());
+    uint32_t target = hiresUsToCounts(microseconds);
+
+    if (taskIndex >= MAX_TASKS) {
+        // Untracked task: fall back to wall-clock time
+        uint32_t start = hiresNow();
+        while (hiresNow() - start < target) {
+        }
+        return;
+    }
+
+    uint32_t start = getTaskExecutionCounts(taskIndex);
+    while (getTaskExecutionCounts(taskIndex) - start < target) {
+    }
+}
+
+// Time every kernel before the scheduler starts, so a job can turn its
+// computation time into a fixed amount of work
+void workloadKernelsInit(void)
+{
+    kernelsInit();
+    printf("Workload Seed: %lu\n", (uint32_t)WORKLOAD_SEED);
+
+    for (UBaseType_t workload = 0; workload < WORKLOAD_COUNT; ++workload) {
+        if (workloadKernels[workload] == NULL) {
+            continue;
+        }
+
+        workloadKernels[workload]();  // Warm up
+        uint32_t start = hiresNow();
+        for (int i = 0; i < WORKLOAD_CALIBRATION_ITERATIONS; ++i) {
+            workloadKernels[workload]();
+        }
+        uint32_t elapsed = hiresNow() - start;
+
+        countsPerIteration[workload] = (uint32_t)(((uint64_t)elapsed * 256) / WORKLOAD_CALIBRATION_ITERATIONS);
+        if (countsPerIteration[workload] == 0) {
+            countsPerIteration[workload] = 1;
+        }
+        printf("Workload %s: %lu us per 100 iterations\n", workloadNames[workload],
+               hiresCountsToUs(countsPerIteration[workload] * 100 / 256));
+    }
+}
+
+// Perform the work calibrated to take the given time. Kernel workloads run a
+// fixed number of iterations, so the execution time actually taken varies
+// with the data and the platform; spinning takes exactly the given time.
+void workloadRun(UBaseType_t workload, uint32_t microseconds)
+{
+    if (workload >= WORKLOAD_COUNT || workloadKernels[workload] == NULL) {
+        burnExecutionTime(microseconds);
+        return;
+    }
+
+    uint64_t scaledCounts = (uint64_t)hiresUsToCounts(microseconds) * 256;
+    uint32_t iterations = (uint32_t)((scaledCounts + countsPerIteration[workload] / 2) / countsPerIteration[workload]);
+
+    if (iterations == 0 && microseconds > 0) {
+        iterations = 1;
+    }
+    for (uint32_t i = 0; i < iterations; ++i) {
+        workloadKernels[workload]();
+    }
+}
+
+const char *workloadName(UBaseType_t workload)
+{
+    return workload < WORKLOAD_COUNT ? workloadNames[workload] : "Unknown";
+}
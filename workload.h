@@ -0,0 +1,22 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include "FreeRTOS.h"
+
+#define US_PER_TICK ( 1000000UL / configTICK_RATE_HZ )
+
+// Work a job performs for its computation time, selected per task set entry
+#define WORKLOAD_SPIN      0  // Spin on the task's execution clock
+#define WORKLOAD_CRC32     1  // Table-driven CRC-32 over a 256-byte message
+#define WORKLOAD_FIR       2  // 32-tap Q15 FIR filter over a 64-sample block
+#define WORKLOAD_MATMUL    3  // 8x8 integer matrix multiply
+#define WORKLOAD_PID       4  // Q16 PID controller closing the loop on a simulated plant
+#define WORKLOAD_SHUFFLE   5  // memcpy-heavy shuffle of buffer segments
+#define WORKLOAD_COUNT     6
+
+void burnExecutionTime(uint32_t microseconds);
+void workloadKernelsInit(void);
+void workloadRun(UBaseType_t workload, uint32_t microseconds);
+const char *workloadName(UBaseType_t workload);
+
+#endif /* WORKLOAD_H */
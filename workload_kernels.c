@@ -0,0 +1,183 @@
+#include "workload_kernels.h"
+#include <string.h>
+
+#define CRC_MESSAGE_BYTES   256
+#define FIR_TAPS            32
+#define FIR_BLOCK           64
+#define MATRIX_SIZE         8
+#define PID_STEPS           32
+#define SHUFFLE_BYTES       2048
+#define SHUFFLE_SEGMENTS    16
+
+static volatile uint32_t kernelSink;
+static uint32_t kernelSeed = WORKLOAD_SEED;
+
+#if WORKLOAD_SEED == 0
+#error "WORKLOAD_SEED must be nonzero, xorshift stays at 0"
+#endif
+
+// Cheap xorshift generator for the kernel inputs
+static uint32_t nextInput(void)
+{
+    kernelSeed ^= kernelSeed << 13;
+    kernelSeed ^= kernelSeed >> 17;
+    kernelSeed ^= kernelSeed << 5;
+    return kernelSeed;
+}
+
+// CRC-32 (IEEE 802.3, reflected)
+static uint32_t crcTable[256];
+static uint8_t crcMessage[CRC_MESSAGE_BYTES];
+
+void kernelCrc32(void)
+{
+    uint32_t crc = 0xFFFFFFFFUL;
+
+    // Change part of the message so successive jobs do not hash identical data
+    crcMessage[nextInput() % CRC_MESSAGE_BYTES] = (uint8_t)nextInput();
+    for (uint32_t i = 0; i < CRC_MESSAGE_BYTES; ++i) {
+        crc = crcTable[(crc ^ crcMessage[i]) & 0xFF] ^ (crc >> 8);
+    }
+    kernelSink ^= ~crc;
+}
+
+// FIR filter on Q15 samples with a saturated Q15 output
+static int16_t firCoefficients[FIR_TAPS];
+static int16_t firHistory[FIR_TAPS + FIR_BLOCK];
+static int16_t firOutput[FIR_BLOCK];
+
+void kernelFir(void)
+{
+    // Shift the history and append a new block of noisy input
+    memmove(firHistory, &firHistory[FIR_BLOCK], FIR_TAPS * sizeof(int16_t));
+    for (uint32_t i = 0; i < FIR_BLOCK; ++i) {
+        firHistory[FIR_TAPS + i] = (int16_t)(nextInput() >> 17) - 16384;
+    }
+
+    for (uint32_t n = 0; n < FIR_BLOCK; ++n) {
+        int32_t accumulator = 0;
+
+        for (uint32_t k = 0; k < FIR_TAPS; ++k) {
+            accumulator += (int32_t)firCoefficients[k] * firHistory[n + FIR_TAPS - k];
+        }
+        accumulator >>= 15;
+        if (accumulator > 32767) {
+            accumulator = 32767;
+        } else if (accumulator < -32768) {
+            accumulator = -32768;
+        }
+        firOutput[n] = (int16_t)accumulator;
+    }
+    kernelSink ^= (uint16_t)firOutput[FIR_BLOCK - 1];
+}
+
+// Integer matrix multiply C = A * B
+static int32_t matrixA[MATRIX_SIZE][MATRIX_SIZE];
+static int32_t matrixB[MATRIX_SIZE][MATRIX_SIZE];
+static int32_t matrixC[MATRIX_SIZE][MATRIX_SIZE];
+
+void kernelMatmul(void)
+{
+    matrixA[nextInput() % MATRIX_SIZE][nextInput() % MATRIX_SIZE] = (int32_t)(nextInput() & 0xFF);
+
+    for (uint32_t i = 0; i < MATRIX_SIZE; ++i) {
+        for (uint32_t j = 0; j < MATRIX_SIZE; ++j) {
+            int32_t sum = 0;
+
+            for (uint32_t k = 0; k < MATRIX_SIZE; ++k) {
+                sum += matrixA[i][k] * matrixB[k][j];
+            }
+            matrixC[i][j] = sum;
+        }
+    }
+    kernelSink ^= (uint32_t)matrixC[MATRIX_SIZE - 1][MATRIX_SIZE - 1];
+}
+
+// Q16 PID with output saturation and anti-windup, driving a first-order plant
+// towards a setpoint that jumps now and then
+#define Q16(x) ((int32_t)((x) * 65536))
+
+static int32_t pidIntegral;
+static int32_t pidPreviousError;
+static int32_t plantOutput;
+static int32_t pidSetpoint = Q16(1);
+
+void kernelPid(void)
+{
+    const int32_t kp = Q16(0.8), ki = Q16(0.05), kd = Q16(0.2);
+    const int32_t outputLimit = Q16(4);
+
+    if ((nextInput() & 0x3F) == 0) {
+        pidSetpoint = (int32_t)(nextInput() % (uint32_t)Q16(3));
+    }
+
+    for (uint32_t step = 0; step < PID_STEPS; ++step) {
+        int32_t error = pidSetpoint - plantOutput;
+        int32_t derivative = error - pidPreviousError;
+        int32_t output = (int32_t)(((int64_t)kp * error + (int64_t)ki * pidIntegral +
+                                    (int64_t)kd * derivative) >> 16);
+
+        // Only integrate while the actuator is not saturated
+        if (output > outputLimit) {
+            output = outputLimit;
+        } else if (output < -outputLimit) {
+            output = -outputLimit;
+        } else {
+            pidIntegral += error;
+        }
+        pidPreviousError = error;
+
+        // Plant: y += (u - y) / 8
+        plantOutput += (output - plantOutput) >> 3;
+    }
+    kernelSink ^= (uint32_t)plantOutput;
+}
+
+// Copy randomly sized segments between two buffers at random offsets
+static uint8_t shuffleSource[SHUFFLE_BYTES];
+static uint8_t shuffleDestination[SHUFFLE_BYTES];
+
+void kernelShuffle(void)
+{
+    for (uint32_t segment = 0; segment < SHUFFLE_SEGMENTS; ++segment) {
+        uint32_t length = 32 + nextInput() % (SHUFFLE_BYTES / SHUFFLE_SEGMENTS);
+        uint32_t from = nextInput() % (SHUFFLE_BYTES - length);
+        uint32_t to = nextInput() % (SHUFFLE_BYTES - length);
+
+        memcpy(&shuffleDestination[to], &shuffleSource[from], length);
+    }
+    memcpy(shuffleSource, shuffleDestination, SHUFFLE_BYTES);
+    kernelSink ^= shuffleSource[nextInput() % SHUFFLE_BYTES];
+}
+
+void kernelsInit(void)
+{
+    for (uint32_t n = 0; n < 256; ++n) {
+        uint32_t crc = n;
+
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320UL : crc >> 1;
+        }
+        crcTable[n] = crc;
+    }
+    for (uint32_t i = 0; i < CRC_MESSAGE_BYTES; ++i) {
+        crcMessage[i] = (uint8_t)nextInput();
+    }
+
+    // Windowed low-pass taps summing to about 1.0 in Q15
+    for (uint32_t k = 0; k < FIR_TAPS; ++k) {
+        uint32_t distance = k < FIR_TAPS / 2 ? FIR_TAPS / 2 - k : k - FIR_TAPS / 2;
+        firCoefficients[k] = (int16_t)((FIR_TAPS / 2 - distance + 1) * 120);
+    }
+
+    for (uint32_t i = 0; i < MATRIX_SIZE; ++i) {
+        for (uint32_t j = 0; j < MATRIX_SIZE; ++j) {
+            matrixA[i][j] = (int32_t)(nextInput() & 0xFF);
+            matrixB[i][j] = (int32_t)(nextInput() & 0xFF);
+        }
+    }
+
+    for (uint32_t i = 0; i < SHUFFLE_BYTES; ++i) {
+        shuffleSource[i] = (uint8_t)nextInput();
+    }
+}
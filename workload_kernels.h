@@ -0,0 +1,22 @@
+#ifndef WORKLOAD_KERNELS_H
+#define WORKLOAD_KERNELS_H
+
+#include "FreeRTOS.h"
+
+// Seed of the generator behind the kernel inputs, fixed so that identical
+// builds do identical work. Override with -DWORKLOAD_SEED=<n>
+#ifndef WORKLOAD_SEED
+#define WORKLOAD_SEED      0x12345678UL
+#endif
+
+// One iteration of each compute kernel. Every call folds its result into a
+// sink so the work cannot be optimized away; state and buffers are shared by
+// all tasks, since only the cost of the work matters here.
+void kernelsInit(void);
+void kernelCrc32(void);
+void kernelFir(void);
+void kernelMatmul(void);
+void kernelPid(void);
+void kernelShuffle(void);
+
+#endif /* WORKLOAD_KERNELS_H */